@@ -0,0 +1,68 @@
+/*
+ * Copyright (c) 2018 Samsung Electronics Co., Ltd. All rights reserved.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA
+ */
+
+#include <rlottie.h>
+
+#include <iostream>
+#include <string>
+
+/*
+ * Converts a lottie json resource to the binary model format
+ * which can be loaded with rlottie::Animation::loadFromBinary().
+ *
+ * Usage: lottie2bin [lottieFileName] [binaryFileName]
+ */
+static int help()
+{
+    std::cout << "Usage: \n   lottie2bin [lottieFileName] [binaryFileName]\n\n"
+                 "Examples: \n"
+                 "    $ lottie2bin input.json\n"
+                 "    $ lottie2bin input.json output.bin\n\n";
+    return 1;
+}
+
+static std::string outputName(const std::string &input)
+{
+    auto pos = input.rfind(".json");
+    if (pos != std::string::npos && pos + 5 == input.size())
+        return input.substr(0, pos) + ".bin";
+
+    return input + ".bin";
+}
+
+int main(int argc, char **argv)
+{
+    if (argc < 2) return help();
+
+    std::string input = argv[1];
+    std::string output = argc > 2 ? argv[2] : outputName(input);
+
+    auto player = rlottie::Animation::loadFromFile(input, false);
+    if (!player) {
+        std::cout << "failed to load : " << input << std::endl;
+        return 1;
+    }
+
+    if (!player->saveToBinary(output)) {
+        std::cout << "failed to write : " << output << std::endl;
+        return 1;
+    }
+
+    std::cout << "Generated Binary file : " << output << std::endl;
+    return 0;
+}
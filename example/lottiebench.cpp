@@ -0,0 +1,365 @@
+/*
+ * Copyright (c) 2018 Samsung Electronics Co., Ltd. All rights reserved.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA
+ */
+
+#include <rlottie.h>
+
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+
+#ifndef _WIN32
+#include <sys/resource.h>
+#endif
+
+/*
+ * Simple benchmark tool which reports the average cost per frame
+ * of the public rlottie api.
+ *
+ * Usage: lottiebench [mode] [lottieFileName] [Resolution] [Iterations]
+ */
+class Bench {
+public:
+    using Clock = std::chrono::high_resolution_clock;
+
+    int setup(int argc, char **argv)
+    {
+        if (argc < 3) return help();
+
+        mode = argv[1];
+        fileName = argv[2];
+
+        if (argc > 3) {
+            const char *x = strchr(argv[3], 'x');
+            if (!x) return help();
+            width = size_t(atoi(argv[3]));
+            height = size_t(atoi(x + 1));
+        }
+        if (argc > 4) iterations = size_t(atoi(argv[4]));
+
+        if (!width || !height || !iterations) return help();
+
+        return 0;
+    }
+
+    int run()
+    {
+        if (mode == "render") return render();
+        if (mode == "tree") return renderTree();
+        if (mode == "load") return load(false);
+        if (mode == "loadbin") return load(true);
+        if (mode == "keyframes") return keyFrames();
+        if (mode == "easing") return easing();
+        if (mode == "stroke") return stroke();
+
+        return help();
+    }
+
+private:
+    int render()
+    {
+        auto player = rlottie::Animation::loadFromFile(fileName);
+        if (!player) return error();
+
+        auto buffer =
+            std::unique_ptr<uint32_t[]>(new uint32_t[width * height]);
+        size_t frameCount = player->totalFrame();
+
+        auto start = Clock::now();
+        for (size_t n = 0; n < iterations; n++) {
+            for (size_t i = 0; i < frameCount; i++) {
+                rlottie::Surface surface(buffer.get(), width, height,
+                                         width * 4);
+                player->renderSync(i, surface);
+            }
+        }
+        return result(start, frameCount * iterations);
+    }
+
+    int renderTree()
+    {
+        auto player = rlottie::Animation::loadFromFile(fileName);
+        if (!player) return error();
+
+        size_t frameCount = player->totalFrame();
+
+        auto start = Clock::now();
+        for (size_t n = 0; n < iterations; n++) {
+            for (size_t i = 0; i < frameCount; i++) {
+                player->renderTree(i, width, height);
+            }
+        }
+        return result(start, frameCount * iterations);
+    }
+
+    /*
+     * model cache is bypassed so every iteration pays the full load cost.
+     * peak rss is reported for the whole process, run one mode per process
+     * to compare them.
+     */
+    int load(bool binary)
+    {
+        auto start = Clock::now();
+        for (size_t n = 0; n < iterations; n++) {
+            auto player = binary
+                              ? rlottie::Animation::loadFromBinary(fileName, false)
+                              : rlottie::Animation::loadFromFile(fileName, false);
+            if (!player) return error();
+        }
+        std::chrono::duration<double> elapsed = Clock::now() - start;
+        result(start, iterations);
+
+        std::ifstream file(fileName, std::ios::binary | std::ios::ate);
+        double        megaBytes = double(file.tellg()) / (1024 * 1024);
+        std::cout << "    speed    : " << megaBytes * iterations / elapsed.count()
+                  << " MB/s\n";
+#ifndef _WIN32
+        struct rusage usage;
+        getrusage(RUSAGE_SELF, &usage);
+        std::cout << "    peak rss : " << usage.ru_maxrss << " KB\n";
+#endif
+        return 0;
+    }
+
+    /*
+     * generated asset where every property of the groups has a keyframe
+     * every span frames.
+     */
+    static std::string keyFrameAsset(size_t frameCount, size_t groupCount,
+                                     size_t span)
+    {
+        auto property = [frameCount, span](std::ostream &os, int dim,
+                                           float scale) {
+            os << "{\"a\":1,\"k\":[";
+            for (size_t i = 0; i < frameCount / span; i++) {
+                os << "{\"t\":" << i * span << ",\"s\":[";
+                for (int d = 0; d < dim; d++)
+                    os << (d ? "," : "") << float((i * 7 + d * 13) % 97) * scale;
+                os << "],\"e\":[";
+                for (int d = 0; d < dim; d++)
+                    os << (d ? "," : "") << float(((i + 1) * 7 + d * 13) % 97) * scale;
+                os << "],\"i\":{\"x\":[0.4],\"y\":[1]},"
+                      "\"o\":{\"x\":[0.6],\"y\":[0]}},";
+            }
+            os << "{\"t\":" << frameCount / span * span << "}]}";
+        };
+
+        std::ostringstream os;
+        os << "{\"v\":\"5.5.2\",\"fr\":60,\"ip\":0,\"op\":" << frameCount
+           << ",\"w\":200,\"h\":200,\"layers\":[{\"ty\":4,\"ind\":1,"
+              "\"ip\":0,\"op\":"
+           << frameCount << ",\"st\":0,\"ks\":{},\"shapes\":[";
+        for (size_t g = 0; g < groupCount; g++) {
+            os << (g ? "," : "") << "{\"ty\":\"gr\",\"it\":[";
+            os << "{\"ty\":\"rc\",\"p\":";
+            property(os, 2, 2.0f);
+            os << ",\"s\":";
+            property(os, 2, 1.0f);
+            os << ",\"r\":{\"a\":0,\"k\":0}},{\"ty\":\"fl\",\"c\":"
+                  "{\"a\":0,\"k\":[1,0,0,1]},\"o\":";
+            property(os, 1, 1.0f);
+            os << "},{\"ty\":\"tr\",\"r\":";
+            property(os, 1, 3.0f);
+            os << "}]}";
+        }
+        os << "]}]}";
+        return os.str();
+    }
+
+    /*
+     * renderTree() cost per frame of a generated keyframe dense asset in
+     * sequential and ping-pong order, fileName is the keyframe count.
+     */
+    int keyFrames()
+    {
+        size_t frameCount = size_t(atoi(fileName.c_str()));
+        if (!frameCount) return help();
+
+        return keyFrameBench(keyFrameAsset(frameCount, 10, 1), frameCount);
+    }
+
+    /*
+     * renderTree() cost per frame of a generated asset with many eased
+     * properties, fileName is the keyframe span in frames.
+     */
+    int easing()
+    {
+        size_t span = size_t(atoi(fileName.c_str()));
+        if (!span || span > 600) return help();
+
+        return keyFrameBench(keyFrameAsset(600, 50, span), 600);
+    }
+
+    /*
+     * generated asset of small icon sized polylines with miter and bevel
+     * joins and butt caps, the groups rotate so every frame strokes them
+     * again.
+     */
+    static std::string strokeAsset(size_t pathCount, size_t frameCount)
+    {
+        std::ostringstream os;
+        os << "{\"v\":\"5.5.2\",\"fr\":60,\"ip\":0,\"op\":" << frameCount
+           << ",\"w\":200,\"h\":200,\"layers\":[{\"ty\":4,\"ind\":1,"
+              "\"ip\":0,\"op\":"
+           << frameCount << ",\"st\":0,\"ks\":{},\"shapes\":[";
+        for (size_t g = 0; g < pathCount; g++) {
+            const size_t vertexCount = 12;
+            const size_t cx = 20 + (g * 53) % 160;
+            const size_t cy = 20 + (g * 97) % 160;
+            os << (g ? "," : "") << "{\"ty\":\"gr\",\"it\":[{\"ty\":\"sh\","
+                                    "\"ks\":{\"a\":0,\"k\":{\"c\":"
+               << (g % 2 ? "true" : "false") << ",\"v\":[";
+            for (size_t v = 0; v < vertexCount; v++) {
+                os << (v ? "," : "") << "[" << cx + (g * 37 + v * 53) % 30 - 15
+                   << "," << cy + (g * 71 + v * 29) % 30 - 15 << "]";
+            }
+            os << "],\"i\":[";
+            for (size_t v = 0; v < vertexCount; v++) os << (v ? "," : "") << "[0,0]";
+            os << "],\"o\":[";
+            for (size_t v = 0; v < vertexCount; v++) os << (v ? "," : "") << "[0,0]";
+            os << "]}}},{\"ty\":\"st\",\"c\":{\"a\":0,\"k\":[0,0,0,1]},"
+                  "\"o\":{\"a\":0,\"k\":100},\"w\":{\"a\":0,\"k\":"
+               << 1 + g % 3 << "},\"lc\":1,\"lj\":" << (g % 2 ? 1 : 3)
+               << ",\"ml\":4},{\"ty\":\"tr\",\"a\":{\"a\":0,\"k\":[" << cx << ","
+               << cy << "]},\"p\":{\"a\":0,\"k\":[" << cx << "," << cy
+               << "]},\"r\":{\"a\":1,\"k\":["
+                  "{\"t\":0,\"s\":[0],\"e\":[360],\"i\":{\"x\":[1],\"y\":[1]},"
+                  "\"o\":{\"x\":[0],\"y\":[0]}},{\"t\":"
+               << frameCount << "}]}}]}";
+        }
+        os << "]}]}";
+        return os.str();
+    }
+
+    /*
+     * renderSync() cost per frame of a generated stroke heavy asset,
+     * fileName is the number of polylines.
+     */
+    int stroke()
+    {
+        size_t pathCount = size_t(atoi(fileName.c_str()));
+        if (!pathCount) return help();
+
+        const size_t frameCount = 120;
+        auto player = rlottie::Animation::loadFromData(
+            strokeAsset(pathCount, frameCount), "lottiebench_stroke", "",
+            false);
+        if (!player) return error();
+
+        auto buffer =
+            std::unique_ptr<uint32_t[]>(new uint32_t[width * height]);
+
+        auto start = Clock::now();
+        for (size_t n = 0; n < iterations; n++) {
+            for (size_t i = 0; i < frameCount; i++) {
+                rlottie::Surface surface(buffer.get(), width, height,
+                                         width * 4);
+                player->renderSync(i, surface);
+            }
+        }
+        return result(start, frameCount * iterations);
+    }
+
+    int keyFrameBench(const std::string &asset, size_t frameCount)
+    {
+        auto player = rlottie::Animation::loadFromData(
+            asset, "lottiebench_keyframes", "", false);
+        if (!player) return error();
+
+        std::string name = mode;
+        auto start = Clock::now();
+        for (size_t n = 0; n < iterations; n++) {
+            for (size_t i = 0; i < frameCount; i++)
+                player->renderTree(i, width, height);
+        }
+        mode = name + " sequential";
+        result(start, frameCount * iterations);
+
+        start = Clock::now();
+        for (size_t n = 0; n < iterations; n++) {
+            for (size_t i = 0; i < frameCount; i++) {
+                player->renderTree(n % 2 ? frameCount - 1 - i : i, width,
+                                   height);
+            }
+        }
+        mode = name + " ping-pong";
+        return result(start, frameCount * iterations);
+    }
+
+    int result(Clock::time_point start, size_t count)
+    {
+        std::chrono::duration<double, std::micro> elapsed =
+            Clock::now() - start;
+        std::cout << mode << " : " << fileName << "\n"
+                  << "    total    : " << elapsed.count() / 1000 << " ms\n"
+                  << "    per call : " << elapsed.count() / count << " us\n";
+        return 0;
+    }
+
+    int error()
+    {
+        std::cout << "failed to load : " << fileName << std::endl;
+        return 1;
+    }
+
+    int help()
+    {
+        std::cout << "Usage: \n   lottiebench [mode] [lottieFileName] "
+                     "[Resolution] [Iterations]\n\n"
+                     "Modes: \n"
+                     "    render : renderSync() cost per frame\n"
+                     "    tree   : renderTree() cost per frame\n"
+                     "    load   : loadFromFile() cost, throughput and peak rss\n"
+                     "    loadbin: loadFromBinary() cost, throughput and peak "
+                     "rss\n"
+                     "    keyframes: renderTree() cost on a generated asset "
+                     "with [lottieFileName] keyframes per property\n"
+                     "    easing : renderTree() cost on a generated asset "
+                     "with a keyframe every [lottieFileName] frames\n"
+                     "    stroke : renderSync() cost on a generated asset "
+                     "with [lottieFileName] stroked polylines\n\n"
+                     "Examples: \n"
+                     "    $ lottiebench tree input.json\n"
+                     "    $ lottiebench render input.json 200x200 10\n"
+                     "    $ lottiebench loadbin input.bin 200x200 100\n"
+                     "    $ lottiebench keyframes 1000 200x200 10\n"
+                     "    $ lottiebench easing 30 200x200 10\n"
+                     "    $ lottiebench stroke 100 200x200 10\n\n";
+        return 1;
+    }
+
+private:
+    std::string mode;
+    std::string fileName;
+    size_t      width{200};
+    size_t      height{200};
+    size_t      iterations{10};
+};
+
+int main(int argc, char **argv)
+{
+    Bench bench;
+
+    if (bench.setup(argc, argv)) return 1;
+
+    return bench.run();
+}
@@ -0,0 +1,32 @@
+#!/bin/sh
+#
+# Compares the json and the binary model load cost of every resource
+# in a directory.
+#
+# Usage: lottiebench_load.sh [buildDir] [resourceDir] [Iterations]
+#
+
+BUILD_DIR=${1:-build}
+RESOURCE_DIR=${2:-$(dirname "$0")/resource}
+ITERATIONS=${3:-20}
+BIN_DIR=$(mktemp -d)
+
+trap 'rm -rf "$BIN_DIR"' EXIT
+
+printf "%-40s %12s %12s %12s %12s\n" "file" "json(us)" "bin(us)" "json(KB)" "bin(KB)"
+
+for json in "$RESOURCE_DIR"/*.json; do
+    name=$(basename "$json" .json)
+    bin="$BIN_DIR/$name.bin"
+
+    "$BUILD_DIR"/example/lottie2bin "$json" "$bin" > /dev/null || continue
+
+    json_out=$("$BUILD_DIR"/example/lottiebench load "$json" 1x1 "$ITERATIONS")
+    bin_out=$("$BUILD_DIR"/example/lottiebench loadbin "$bin" 1x1 "$ITERATIONS")
+
+    printf "%-40s %12s %12s %12s %12s\n" "$name" \
+        "$(echo "$json_out" | awk '/per call/ {print $4}')" \
+        "$(echo "$bin_out" | awk '/per call/ {print $4}')" \
+        "$(echo "$json_out" | awk '/peak rss/ {print $4}')" \
+        "$(echo "$bin_out" | awk '/peak rss/ {print $4}')"
+done
@@ -60,6 +60,73 @@ namespace rlottie {
  */
 LOT_EXPORT void configureModelCacheSize(size_t cacheSize);
 
+/**
+ *  @brief Configures rlottie image cache budget.
+ *
+ *  Image assets are decoded on first use and the decoded bitmaps
+ *  are shared between animations. They are kept until the total
+ *  size of the decoded images and of the encoded data they hold
+ *  exceeds the budget, then the least recently used ones are
+ *  released. Released images are decoded again when needed.
+ *
+ *  @param[in] cacheSize  Maximum image cache memory in bytes.
+ *
+ *  @note configuring it with 0 releases all the cached images, the
+ *        ones currently on screen are freed once they go off screen.
+ *
+ *  @internal
+ */
+LOT_EXPORT void configureImageCacheSize(size_t cacheSize);
+
+struct ImageCacheStats {
+    size_t hits{0};       /* number of lookups served from the cache */
+    size_t misses{0};     /* number of lookups that needed a decode */
+    size_t evictions{0};  /* number of images released by the budget */
+    size_t count{0};      /* number of decoded images in the cache */
+    size_t size{0};       /* decoded image and encoded data memory in bytes */
+    size_t dataSize{0};   /* encoded data memory in bytes, part of size */
+};
+
+/**
+ *  @brief Returns the statistics of the rlottie image cache.
+ *
+ *  Images are cached by the content of the embedded data or by
+ *  the resolved file path, modification time and size, and are
+ *  shared between all the animations using the same image. Image
+ *  files are checked when the animation is loaded only, a cached
+ *  image is not revalidated against the file.
+ *
+ *  @return current image cache statistics.
+ *
+ *  @see configureImageCacheSize()
+ *
+ *  @internal
+ */
+LOT_EXPORT ImageCacheStats imageCacheStats();
+
+enum class TrimLevel {
+    Moderate,  /* drop unused cached models and gradient color tables */
+    Complete   /* Moderate + drop all the decoded images */
+};
+
+/**
+ *  @brief Releases library level memory on memory pressure.
+ *
+ *  Dropped data is recreated lazily when it is needed again.
+ *  To release the memory held by an Animation object
+ *  use @see Animation::releaseResources() as well.
+ *
+ *  @param[in] level  how much memory to release.
+ *
+ *  @return number of bytes freed.
+ *
+ *  @note size of the released models is not accounted in the
+ *        returned value.
+ *
+ *  @internal
+ */
+LOT_EXPORT size_t trimMemory(TrimLevel level);
+
 struct Color {
     Color() = default;
     Color(float r, float g , float b):_r(r), _g(g), _b(b){}
@@ -301,6 +368,144 @@ public:
     loadFromData(std::string jsonData, const std::string &key,
                  const std::string &resourcePath="", bool cachePolicy=true);
 
+    /**
+     *  @brief Constructs an animation object from a JSON buffer owned by
+     *         the caller.
+     *
+     *  The buffer is neither copied nor modified, only the string values
+     *  needed by the model are copied while parsing. It doesn't need to be
+     *  null terminated and can be released once this call returns.
+     *
+     *  @param[in] data The JSON data.
+     *  @param[in] size size of the JSON data in bytes.
+     *  @param[in] key the string that will be used to cache the JSON data.
+     *  @param[in] resourcePath the path will be used to search for external resource.
+     *  @param[in] cachePolicy whether to cache or not the model data.
+     *
+     *  @return Animation object that can render the contents of the
+     *          Lottie resource represented by JSON data.
+     *
+     *  @internal
+     */
+    static std::unique_ptr<Animation>
+    loadFromData(const char *data, size_t size, const std::string &key,
+                 const std::string &resourcePath="", bool cachePolicy=true);
+
+    /**
+     *  @brief Constructs an animation object from a binary model file
+     *         created by saveToBinary().
+     *
+     *  The file is memory mapped and the model is built directly from it
+     *  without any json parsing, which makes it the fastest way to load
+     *  a resource that is used often.
+     *
+     *  @param[in] path binary model file path.
+     *  @param[in] cachePolicy whether to cache or not the model data.
+     *
+     *  @return Animation object that can render the contents of the
+     *          binary model, or null if the file is not a valid binary
+     *          model of the current version.
+     *
+     *  @see saveToBinary()
+     *
+     *  @internal
+     */
+    static std::unique_ptr<Animation>
+    loadFromBinary(const std::string &path, bool cachePolicy=true);
+
+    /**
+     *  @brief Callback type of the asynchronous load functions. It is called
+     *         with the loaded animation, or null if the load failed.
+     */
+    using LoadCallback = std::function<void(std::unique_ptr<Animation>)>;
+
+    /**
+     *  @brief Loads an animation from file path without blocking the caller.
+     *
+     *  Parsing, decoding of the image assets and the model cache insertion
+     *  run on the library thread pool. Concurrent loads of the same cached
+     *  resource share a single parse, the ones waiting for it don't hold
+     *  a pool thread.
+     *
+     *  @param[in] path Lottie resource file path
+     *  @param[in] cachePolicy whether to cache or not the model data.
+     *
+     *  @return future that becomes ready with the loaded animation, or
+     *          null if the load failed.
+     *
+     *  @see loadFromFile()
+     *
+     *  @internal
+     */
+    static std::future<std::unique_ptr<Animation>>
+    loadFromFileAsync(const std::string &path, bool cachePolicy=true);
+
+    /**
+     *  @brief Loads an animation from file path without blocking the caller
+     *         and passes the result to callback.
+     *
+     *  @param[in] path Lottie resource file path
+     *  @param[in] callback called from a pool thread once the load is done.
+     *  @param[in] cachePolicy whether to cache or not the model data.
+     *
+     *  @internal
+     */
+    static void
+    loadFromFileAsync(const std::string &path, LoadCallback callback,
+                      bool cachePolicy=true);
+
+    /**
+     *  @brief Loads an animation from JSON string data without blocking
+     *         the caller.
+     *
+     *  @param[in] jsonData The JSON string data.
+     *  @param[in] key the string that will be used to cache the JSON string data.
+     *  @param[in] resourcePath the path will be used to search for external resource.
+     *  @param[in] cachePolicy whether to cache or not the model data.
+     *
+     *  @return future that becomes ready with the loaded animation, or
+     *          null if the load failed.
+     *
+     *  @see loadFromData()
+     *
+     *  @internal
+     */
+    static std::future<std::unique_ptr<Animation>>
+    loadFromDataAsync(std::string jsonData, const std::string &key,
+                      const std::string &resourcePath="", bool cachePolicy=true);
+
+    /**
+     *  @brief Loads an animation from JSON string data without blocking
+     *         the caller and passes the result to callback.
+     *
+     *  @param[in] jsonData The JSON string data.
+     *  @param[in] key the string that will be used to cache the JSON string data.
+     *  @param[in] callback called from a pool thread once the load is done.
+     *  @param[in] resourcePath the path will be used to search for external resource.
+     *  @param[in] cachePolicy whether to cache or not the model data.
+     *
+     *  @internal
+     */
+    static void
+    loadFromDataAsync(std::string jsonData, const std::string &key,
+                      LoadCallback callback, const std::string &resourcePath="",
+                      bool cachePolicy=true);
+
+    /**
+     *  @brief Writes the parsed model of this animation in the versioned
+     *         binary format that can be loaded back by loadFromBinary().
+     *
+     *  @param[in] path output file path.
+     *
+     *  @return true if the file is written successfully.
+     *
+     *  @note the binary format is only meant to be used with the same
+     *        version of the library, regenerate the file after upgrading.
+     *
+     *  @internal
+     */
+    bool saveToBinary(const std::string &path) const;
+
     /**
      *  @brief Returns default framerate of the Lottie resource.
      *
@@ -456,6 +661,22 @@ public:
         setValue(MapType<std::integral_constant<Property, prop>>{}, prop, keypath, value);
     }
 
+    /**
+     *  @brief Releases the rendering resources of the animation
+     *         (rasterized data, layer buffers and image textures).
+     *
+     *  The animation stays valid and the resources are recreated
+     *  on the next render call.
+     *
+     *  @return number of bytes freed.
+     *
+     *  @note if an async render is in progress the call waits for it
+     *        to finish before releasing the resources.
+     *
+     *  @internal
+     */
+    size_t releaseResources();
+
     /**
      *  @brief default destructor
      *
@@ -72,6 +72,55 @@ LOT_EXPORT Lottie_Animation *lottie_animation_from_file(const char *path);
  */
 LOT_EXPORT Lottie_Animation *lottie_animation_from_data(const char *data, const char *key, const char *resource_path);
 
+/**
+ *  @brief Callback of the asynchronous load functions.
+ *
+ *  @param[in] animation the loaded Animation object, or NULL if the load failed.
+ *             The callback owns it and has to free it with lottie_animation_destroy().
+ *  @param[in] user_data the data passed to the load function.
+ *
+ *  @ingroup Lottie_Animation
+ *  @internal
+ */
+typedef void (*Lottie_Animation_Load_Cb)(Lottie_Animation *animation, void *user_data);
+
+/**
+ *  @brief Constructs an animation object from file path without blocking the caller.
+ *
+ *  The resource is parsed on the library thread pool and @p cb is called
+ *  from a pool thread once it is done. Concurrent loads of the same
+ *  resource share a single parse.
+ *
+ *  @param[in] path Lottie resource file path
+ *  @param[in] cb called with the Animation object once the load is done.
+ *  @param[in] user_data passed to @p cb.
+ *
+ *  @see lottie_animation_from_file()
+ *
+ *  @ingroup Lottie_Animation
+ *  @internal
+ */
+LOT_EXPORT void lottie_animation_from_file_async(const char *path, Lottie_Animation_Load_Cb cb, void *user_data);
+
+/**
+ *  @brief Constructs an animation object from JSON string data without blocking the caller.
+ *
+ *  The data is copied before this call returns, then parsed on the library
+ *  thread pool and @p cb is called from a pool thread once it is done.
+ *
+ *  @param[in] data The JSON string data.
+ *  @param[in] key the string that will be used to cache the JSON string data.
+ *  @param[in] resource_path the path that will be used to load external resource needed by the JSON data.
+ *  @param[in] cb called with the Animation object once the load is done.
+ *  @param[in] user_data passed to @p cb.
+ *
+ *  @see lottie_animation_from_data()
+ *
+ *  @ingroup Lottie_Animation
+ *  @internal
+ */
+LOT_EXPORT void lottie_animation_from_data_async(const char *data, const char *key, const char *resource_path, Lottie_Animation_Load_Cb cb, void *user_data);
+
 /**
  *  @brief Free given Animation object resource.
  *
@@ -46,7 +46,9 @@ LOT_EXPORT Lottie_Animation_S *lottie_animation_from_file(const char *path)
 
 LOT_EXPORT Lottie_Animation_S *lottie_animation_from_data(const char *data, const char *key, const char *resourcePath)
 {
-    if (auto animation = Animation::loadFromData(data, key, resourcePath) ) {
+    if (!data) return nullptr;
+
+    if (auto animation = Animation::loadFromData(data, strlen(data), key, resourcePath) ) {
         Lottie_Animation_S *handle = new Lottie_Animation_S();
         handle->mAnimation = std::move(animation);
         return handle;
@@ -55,6 +57,45 @@ LOT_EXPORT Lottie_Animation_S *lottie_animation_from_data(const char *data, cons
     }
 }
 
+static void lottie_animation_loaded(std::unique_ptr<Animation> animation,
+                                    Lottie_Animation_Load_Cb cb, void *user_data)
+{
+    Lottie_Animation_S *handle = nullptr;
+    if (animation) {
+        handle = new Lottie_Animation_S();
+        handle->mAnimation = std::move(animation);
+    }
+    cb(handle, user_data);
+}
+
+LOT_EXPORT void lottie_animation_from_file_async(const char *path, Lottie_Animation_Load_Cb cb, void *user_data)
+{
+    if (!cb) return;
+
+    if (!path) {
+        cb(nullptr, user_data);
+        return;
+    }
+
+    Animation::loadFromFileAsync(path, [cb, user_data](std::unique_ptr<Animation> animation) {
+        lottie_animation_loaded(std::move(animation), cb, user_data);
+    });
+}
+
+LOT_EXPORT void lottie_animation_from_data_async(const char *data, const char *key, const char *resourcePath, Lottie_Animation_Load_Cb cb, void *user_data)
+{
+    if (!cb) return;
+
+    if (!data || !key) {
+        cb(nullptr, user_data);
+        return;
+    }
+
+    Animation::loadFromDataAsync(data, key, [cb, user_data](std::unique_ptr<Animation> animation) {
+        lottie_animation_loaded(std::move(animation), cb, user_data);
+    }, resourcePath ? resourcePath : "");
+}
+
 LOT_EXPORT void lottie_animation_destroy(Lottie_Animation_S *animation)
 {
     if (animation) {
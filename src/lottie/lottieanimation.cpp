@@ -19,9 +19,12 @@
 #include "lottieitem.h"
 #include "lottieloader.h"
 #include "lottiemodel.h"
+#include "lottietaskscheduler.h"
 #include "rlottie.h"
+#include "vdrawhelper.h"
 
 #include <fstream>
+#include <mutex>
 
 using namespace rlottie;
 
@@ -30,6 +33,32 @@ LOT_EXPORT void rlottie::configureModelCacheSize(size_t cacheSize)
     LottieLoader::configureModelCacheSize(cacheSize);
 }
 
+LOT_EXPORT void rlottie::configureImageCacheSize(size_t cacheSize)
+{
+    LOTAsset::configureImageCacheSize(cacheSize);
+}
+
+LOT_EXPORT size_t rlottie::trimMemory(TrimLevel level)
+{
+    LottieLoader::releaseUnusedModels();
+    size_t bytes = vReleaseGradientCache();
+    if (level == TrimLevel::Complete) bytes += LOTAsset::releaseImageCache();
+    return bytes;
+}
+
+LOT_EXPORT rlottie::ImageCacheStats rlottie::imageCacheStats()
+{
+    LOTImageCacheStats stats = LOTAsset::imageCacheStats();
+    ImageCacheStats    result;
+    result.hits = stats.hits;
+    result.misses = stats.misses;
+    result.evictions = stats.evictions;
+    result.count = stats.count;
+    result.size = stats.size;
+    result.dataSize = stats.dataSize;
+    return result;
+}
+
 struct RenderTask {
     RenderTask() { receiver = sender.get_future(); }
     std::promise<Surface> sender;
@@ -53,6 +82,11 @@ public:
     Surface render(size_t frameNo, const Surface &surface, bool keepAspectRatio);
     std::future<Surface> renderAsync(size_t frameNo, Surface &&surface, bool keepAspectRatio);
     const LOTLayerNode * renderTree(size_t frameNo, const VSize &size);
+    size_t releaseResources();
+    bool saveToBinary(const std::string &path) const
+    {
+        return LottieLoader::saveToBinary(*mModel, path);
+    }
 
     const LayerInfoList &layerInfoList() const
     {
@@ -71,6 +105,7 @@ private:
     std::unique_ptr<LOTCompItem> mCompItem;
     SharedRenderTask             mTask;
     std::atomic<bool>            mRenderInProgress;
+    std::mutex                   mRenderMutex;  // held while rendering
 };
 
 void AnimationImpl::setValue(const std::string &keypath, LOTVariant &&value)
@@ -107,14 +142,24 @@ Surface AnimationImpl::render(size_t frameNo, const Surface &surface, bool keepA
     }
 
     mRenderInProgress.store(true);
-    update(frameNo,
-           VSize(int(surface.drawRegionWidth()), int(surface.drawRegionHeight())), keepAspectRatio);
-    mCompItem->render(surface);
+    {
+        std::lock_guard<std::mutex> guard(mRenderMutex);
+        update(frameNo,
+               VSize(int(surface.drawRegionWidth()), int(surface.drawRegionHeight())), keepAspectRatio);
+        mCompItem->render(surface);
+    }
     mRenderInProgress.store(false);
 
     return surface;
 }
 
+size_t AnimationImpl::releaseResources()
+{
+    // waits for the rendering in progress to finish.
+    std::lock_guard<std::mutex> guard(mRenderMutex);
+    return mCompItem->releaseResources();
+}
+
 void AnimationImpl::init(const std::shared_ptr<LOTModel> &model)
 {
     mModel = model;
@@ -122,54 +167,11 @@ void AnimationImpl::init(const std::shared_ptr<LOTModel> &model)
     mRenderInProgress = false;
 }
 
-#ifdef LOTTIE_THREAD_SUPPORT
-
-#include <thread>
-#include "vtaskqueue.h"
-
 /*
- * Implement a task stealing schduler to perform render task
- * As each player draws into its own buffer we can delegate this
- * task to a slave thread. The scheduler creates a threadpool depending
- * on the number of cores available in the system and does a simple fair
- * scheduling by assigning the task in a round-robin fashion. Each thread
- * in the threadpool has its own queue. once it finishes all the task on its
- * own queue it goes through rest of the queue and looks for task if it founds
- * one it steals the task from it and executes. if it couldn't find one then it
- * just waits for new task on its own queue.
+ * As each player draws into its own buffer the render task can be
+ * delegated to the shared thread pool.
  */
 class RenderTaskScheduler {
-    const unsigned           _count{std::thread::hardware_concurrency()};
-    std::vector<std::thread> _threads;
-    std::vector<TaskQueue<SharedRenderTask>> _q{_count};
-    std::atomic<unsigned>                    _index{0};
-
-    void run(unsigned i)
-    {
-        while (true) {
-            bool             success = false;
-            SharedRenderTask task;
-            for (unsigned n = 0; n != _count * 32; ++n) {
-                if (_q[(i + n) % _count].try_pop(task)) {
-                    success = true;
-                    break;
-                }
-            }
-            if (!success && !_q[i].pop(task)) break;
-
-            auto result =
-                task->playerImpl->render(task->frameNo, task->surface, task->keepAspectRatio);
-            task->sender.set_value(result);
-        }
-    }
-
-    RenderTaskScheduler()
-    {
-        for (unsigned n = 0; n != _count; ++n) {
-            _threads.emplace_back([&, n] { run(n); });
-        }
-    }
-
 public:
     static RenderTaskScheduler &instance()
     {
@@ -177,48 +179,18 @@ public:
         return singleton;
     }
 
-    ~RenderTaskScheduler()
-    {
-        for (auto &e : _q) e.done();
-
-        for (auto &e : _threads) e.join();
-    }
-
     std::future<Surface> process(SharedRenderTask task)
     {
         auto receiver = std::move(task->receiver);
-        auto i = _index++;
-
-        for (unsigned n = 0; n != _count; ++n) {
-            if (_q[(i + n) % _count].try_push(std::move(task))) return receiver;
-        }
-
-        if (_count > 0) {
-            _q[i % _count].push(std::move(task));
-        }
-
+        LottieTaskScheduler::instance().process([task] {
+            auto result = task->playerImpl->render(task->frameNo, task->surface,
+                                                   task->keepAspectRatio);
+            task->sender.set_value(result);
+        });
         return receiver;
     }
 };
 
-#else
-class RenderTaskScheduler {
-public:
-    static RenderTaskScheduler &instance()
-    {
-        static RenderTaskScheduler singleton;
-        return singleton;
-    }
-
-    std::future<Surface> process(SharedRenderTask task)
-    {
-        auto result = task->playerImpl->render(task->frameNo, task->surface, task->keepAspectRatio);
-        task->sender.set_value(result);
-        return std::move(task->receiver);
-    }
-};
-#endif
-
 std::future<Surface> AnimationImpl::renderAsync(size_t    frameNo,
                                                 Surface &&surface,
                                                 bool keepAspectRatio)
@@ -261,6 +233,25 @@ std::unique_ptr<Animation> Animation::loadFromData(
     return nullptr;
 }
 
+std::unique_ptr<Animation> Animation::loadFromData(
+    const char *data, size_t size, const std::string &key,
+    const std::string &resourcePath, bool cachePolicy)
+{
+    if (!data || !size) {
+        vWarning << "jason data is empty";
+        return nullptr;
+    }
+
+    LottieLoader loader;
+    if (loader.loadFromData(data, size, key,
+                            (resourcePath.empty() ? " " : resourcePath), cachePolicy)) {
+        auto animation = std::unique_ptr<Animation>(new Animation);
+        animation->d->init(loader.model());
+        return animation;
+    }
+    return nullptr;
+}
+
 std::unique_ptr<Animation>
 Animation::loadFromFile(const std::string &path, bool cachePolicy)
 {
@@ -278,6 +269,100 @@ Animation::loadFromFile(const std::string &path, bool cachePolicy)
     return nullptr;
 }
 
+std::unique_ptr<Animation>
+Animation::loadFromBinary(const std::string &path, bool cachePolicy)
+{
+    if (path.empty()) {
+        vWarning << "File path is empty";
+        return nullptr;
+    }
+
+    LottieLoader loader;
+    if (loader.loadFromBinary(path, cachePolicy)) {
+        auto animation = std::unique_ptr<Animation>(new Animation);
+        animation->d->init(loader.model());
+        return animation;
+    }
+    return nullptr;
+}
+
+void Animation::loadFromFileAsync(const std::string &path,
+                                  LoadCallback callback, bool cachePolicy)
+{
+    LottieTaskScheduler::instance().process([path, callback, cachePolicy]() {
+        if (path.empty()) return callback(nullptr);
+
+        LottieLoader::loadAsync(path, cachePolicy,
+                                [callback](LottieLoader &loader) {
+            std::unique_ptr<Animation> animation;
+            if (loader.model()) {
+                loader.decodeImages();
+                animation = std::unique_ptr<Animation>(new Animation);
+                animation->d->init(loader.model());
+            }
+            callback(std::move(animation));
+        });
+    });
+}
+
+std::future<std::unique_ptr<Animation>>
+Animation::loadFromFileAsync(const std::string &path, bool cachePolicy)
+{
+    auto sender = std::make_shared<std::promise<std::unique_ptr<Animation>>>();
+    auto receiver = sender->get_future();
+    loadFromFileAsync(
+        path,
+        [sender](std::unique_ptr<Animation> animation) {
+            sender->set_value(std::move(animation));
+        },
+        cachePolicy);
+    return receiver;
+}
+
+void Animation::loadFromDataAsync(std::string jsonData, const std::string &key,
+                                  LoadCallback callback,
+                                  const std::string &resourcePath,
+                                  bool cachePolicy)
+{
+    std::string path = resourcePath.empty() ? " " : resourcePath;
+    LottieTaskScheduler::instance().process(
+        [data = std::move(jsonData), key, path, callback, cachePolicy]() mutable {
+            if (data.empty()) return callback(nullptr);
+
+            LottieLoader::loadFromDataAsync(
+                std::move(data), key, path, cachePolicy,
+                [callback](LottieLoader &loader) {
+                    std::unique_ptr<Animation> animation;
+                    if (loader.model()) {
+                        loader.decodeImages();
+                        animation = std::unique_ptr<Animation>(new Animation);
+                        animation->d->init(loader.model());
+                    }
+                    callback(std::move(animation));
+                });
+        });
+}
+
+std::future<std::unique_ptr<Animation>>
+Animation::loadFromDataAsync(std::string jsonData, const std::string &key,
+                             const std::string &resourcePath, bool cachePolicy)
+{
+    auto sender = std::make_shared<std::promise<std::unique_ptr<Animation>>>();
+    auto receiver = sender->get_future();
+    loadFromDataAsync(
+        std::move(jsonData), key,
+        [sender](std::unique_ptr<Animation> animation) {
+            sender->set_value(std::move(animation));
+        },
+        resourcePath, cachePolicy);
+    return receiver;
+}
+
+bool Animation::saveToBinary(const std::string &path) const
+{
+    return d->saveToBinary(path);
+}
+
 void Animation::size(size_t &width, size_t &height) const
 {
     VSize sz = d->size();
@@ -322,6 +407,11 @@ void Animation::renderSync(size_t frameNo, Surface surface, bool keepAspectRatio
     d->render(frameNo, surface, keepAspectRatio);
 }
 
+size_t Animation::releaseResources()
+{
+    return d->releaseResources();
+}
+
 const LayerInfoList &Animation::layers() const
 {
     return d->layerInfoList();
@@ -0,0 +1,1091 @@
+/*
+ * Copyright (c) 2018 Samsung Electronics Co., Ltd. All rights reserved.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA
+ */
+
+#include "lottiebinary.h"
+#include <cstring>
+#include <unordered_map>
+#include "vdebug.h"
+
+/*
+ * File layout:
+ *   header      : "RLOT" | version (u32) | byte order mark (u32)
+ *   composition : fields | markers | layer infos | assets | root layer
+ *
+ * Every model object starts with its LOTData::Type (0 for a null object),
+ * the static/hidden flags and the name, followed by the type specific data.
+ * Strings are stored as a u32 length and the bytes (length 0xFFFFFFFF for
+ * a null string). Interpolators are shared through a table that is built
+ * while writing, the first use of an interpolator stores its control points
+ * and later uses only refer to its index.
+ */
+
+static const char     magic[4] = {'R', 'L', 'O', 'T'};
+static const uint32_t byteOrderMark = 0x01020304;
+static const size_t   headerSize = sizeof(magic) + 2 * sizeof(uint32_t);
+static const uint32_t nullString = 0xFFFFFFFF;
+static const uint32_t noInterpolator = 0xFFFFFFFF;
+// guard against corrupted data that nests objects without end.
+static const int      maxDepth = 256;
+
+static_assert(sizeof(VPointF) == 2 * sizeof(float),
+              "VPointF is stored as packed float pair");
+
+class LottieBinaryWriter {
+public:
+    LottieBinaryWriter(const LOTCompositionData *comp, std::string &out)
+        : mComp(comp), mOut(out)
+    {
+    }
+    void write()
+    {
+        putString(mComp->mVersion);
+        put(int32_t(mComp->mSize.width()));
+        put(int32_t(mComp->mSize.height()));
+        put(int64_t(mComp->mStartFrame));
+        put(int64_t(mComp->mEndFrame));
+        put(mComp->mFrameRate);
+        put(uint8_t(mComp->mBlendMode));
+        put(uint8_t(mComp->isStatic()));
+        putMarkers(mComp->mMarkers);
+        putMarkers(mComp->mLayerInfoList);
+
+        put(uint32_t(mComp->mAssets.size()));
+        for (const auto &i : mComp->mAssets) putAsset(i.second.get());
+
+        putData(mComp->mRootLayer.get());
+    }
+
+private:
+    template <typename T>
+    void put(T value)
+    {
+        mOut.append(reinterpret_cast<const char *>(&value), sizeof(T));
+    }
+    void putBytes(const void *data, size_t size)
+    {
+        mOut.append(static_cast<const char *>(data), size);
+    }
+    void putString(const char *str)
+    {
+        if (!str) return put(nullString);
+
+        auto len = strlen(str);
+        put(uint32_t(len));
+        putBytes(str, len);
+    }
+    void putString(const std::string &str)
+    {
+        put(uint32_t(str.size()));
+        putBytes(str.data(), str.size());
+    }
+    void putMarkers(const std::vector<Marker> &markers)
+    {
+        put(uint32_t(markers.size()));
+        for (const auto &marker : markers) {
+            putString(std::get<0>(marker));
+            put(int32_t(std::get<1>(marker)));
+            put(int32_t(std::get<2>(marker)));
+        }
+    }
+
+    void putValue(float value) { put(value); }
+    void putValue(const VPointF &pt)
+    {
+        put(pt.x());
+        put(pt.y());
+    }
+    void putValue(const LottieColor &color)
+    {
+        put(color.r);
+        put(color.g);
+        put(color.b);
+    }
+    void putValue(const LottieShapeData &shape)
+    {
+        put(uint32_t(shape.mPoints.size()));
+        putBytes(shape.mPoints.data(), shape.mPoints.size() * sizeof(VPointF));
+        put(uint8_t(shape.mClosed));
+    }
+    void putValue(const LottieGradient &gradient)
+    {
+        put(uint32_t(gradient.mGradient.size()));
+        putBytes(gradient.mGradient.data(),
+                 gradient.mGradient.size() * sizeof(float));
+    }
+
+    template <typename T>
+    void putKeyFrameValue(const LOTKeyFrameValue<T> &value)
+    {
+        putValue(value.mStartValue);
+        putValue(value.mEndValue);
+    }
+    void putKeyFrameValue(const LOTKeyFrameValue<VPointF> &value)
+    {
+        putValue(value.mStartValue);
+        putValue(value.mEndValue);
+        putValue(value.mInTangent);
+        putValue(value.mOutTangent);
+        put(uint8_t(value.mPathKeyFrame));
+    }
+
+    void putInterpolator(const VInterpolator *interpolator)
+    {
+        if (!interpolator) return put(noInterpolator);
+
+        auto result = mInterpolators.emplace(interpolator,
+                                             uint32_t(mInterpolators.size()));
+        put(result.first->second);
+        // first use, store the control points.
+        if (result.second) {
+            putValue(interpolator->p1());
+            putValue(interpolator->p2());
+        }
+    }
+
+    template <typename T>
+    void putAnimatable(const LOTAnimatable<T> &obj)
+    {
+        put(uint8_t(obj.isStatic()));
+        if (obj.isStatic()) return putValue(obj.value());
+
+        const auto &keyFrames = obj.animation().mKeyFrames;
+        put(uint32_t(keyFrames.size()));
+        for (const auto &keyFrame : keyFrames) {
+            put(keyFrame.mStartFrame);
+            put(keyFrame.mEndFrame);
+            putInterpolator(keyFrame.mInterpolator.get());
+            putKeyFrameValue(keyFrame.mValue);
+        }
+    }
+
+    void putDash(const LOTDashProperty &dash)
+    {
+        put(uint32_t(dash.mData.size()));
+        for (const auto &elm : dash.mData) putAnimatable(elm);
+    }
+
+    void putAsset(const LOTAsset *asset)
+    {
+        put(uint8_t(asset->mAssetType));
+        put(uint8_t(asset->isStatic()));
+        putString(asset->mRefId);
+        put(uint32_t(asset->mLayers.size()));
+        for (const auto &layer : asset->mLayers) putData(layer.get());
+        put(int32_t(asset->mWidth));
+        put(int32_t(asset->mHeight));
+        putString(asset->mImageData ? *asset->mImageData : std::string());
+        putString(asset->mImagePath);
+    }
+
+    void putData(const LOTData *obj)
+    {
+        if (!obj) return put(uint8_t(0));
+
+        put(uint8_t(obj->type()));
+        put(uint8_t((obj->isStatic() ? 1 : 0) | (obj->hidden() ? 2 : 0)));
+        putString(obj->name());
+
+        switch (obj->type()) {
+        case LOTData::Type::Layer:
+            putContent(static_cast<const LOTLayerData *>(obj));
+            break;
+        case LOTData::Type::ShapeGroup:
+            putGroup(static_cast<const LOTGroupData *>(obj), true);
+            break;
+        case LOTData::Type::Transform:
+            putContent(static_cast<const LOTTransformData *>(obj));
+            break;
+        case LOTData::Type::Fill:
+            putContent(static_cast<const LOTFillData *>(obj));
+            break;
+        case LOTData::Type::Stroke:
+            putContent(static_cast<const LOTStrokeData *>(obj));
+            break;
+        case LOTData::Type::GFill:
+            putContent(static_cast<const LOTGFillData *>(obj));
+            break;
+        case LOTData::Type::GStroke:
+            putContent(static_cast<const LOTGStrokeData *>(obj));
+            break;
+        case LOTData::Type::Rect:
+            putContent(static_cast<const LOTRectData *>(obj));
+            break;
+        case LOTData::Type::Ellipse:
+            putContent(static_cast<const LOTEllipseData *>(obj));
+            break;
+        case LOTData::Type::Shape:
+            putContent(static_cast<const LOTShapeData *>(obj));
+            break;
+        case LOTData::Type::Polystar:
+            putContent(static_cast<const LOTPolystarData *>(obj));
+            break;
+        case LOTData::Type::Trim:
+            putContent(static_cast<const LOTTrimData *>(obj));
+            break;
+        case LOTData::Type::Repeater:
+            putContent(static_cast<const LOTRepeaterData *>(obj));
+            break;
+        default:
+            break;
+        }
+    }
+
+    void putGroup(const LOTGroupData *obj, bool children)
+    {
+        putData(obj->mTransform.get());
+        if (!children) return put(uint32_t(0));
+
+        put(uint32_t(obj->mChildren.size()));
+        for (const auto &child : obj->mChildren) putData(child.get());
+    }
+
+    // children of a precomp layer are the layers of its asset,
+    // they are linked again when the model is loaded.
+    bool linkedToAsset(const LOTLayerData *layer) const
+    {
+        return layer->mLayerType == LayerType::Precomp && layer->mExtra &&
+               layer->mExtra->mPreCompRefId &&
+               mComp->mAssets.count(layer->mExtra->mPreCompRefId);
+    }
+
+    void putContent(const LOTLayerData *layer)
+    {
+        putGroup(layer, !linkedToAsset(layer));
+        put(uint8_t(layer->mMatteType));
+        put(uint8_t(layer->mLayerType));
+        put(uint8_t(layer->mBlendMode));
+        put(uint8_t(layer->mHasPathOperator));
+        put(uint8_t(layer->mHasMask));
+        put(uint8_t(layer->mHasRepeater));
+        put(uint8_t(layer->mHasGradient));
+        put(uint8_t(layer->mAutoOrient));
+        put(int32_t(layer->mLayerSize.width()));
+        put(int32_t(layer->mLayerSize.height()));
+        put(int32_t(layer->mParentId));
+        put(int32_t(layer->mId));
+        put(layer->mTimeStreatch);
+        put(int32_t(layer->mInFrame));
+        put(int32_t(layer->mOutFrame));
+        put(int32_t(layer->mStartFrame));
+
+        const auto extra = layer->mExtra.get();
+        put(uint8_t(extra != nullptr));
+        if (!extra) return;
+
+        putValue(extra->mSolidColor);
+        putString(extra->mPreCompRefId);
+        putAnimatable(extra->mTimeRemap);
+        put(uint32_t(extra->mMasks.size()));
+        for (const auto &mask : extra->mMasks) {
+            putAnimatable(mask->mShape);
+            putAnimatable(mask->mOpacity);
+            put(uint8_t(mask->mInv));
+            put(uint8_t(mask->mIsStatic));
+            put(uint8_t(mask->mMode));
+        }
+    }
+
+    void putContent(const LOTTransformData *obj)
+    {
+        const auto data = obj->data();
+        if (!data) {
+            auto m = obj->matrix(0);
+            put(m.m_11());
+            put(m.m_12());
+            put(m.m_13());
+            put(m.m_21());
+            put(m.m_22());
+            put(m.m_23());
+            put(m.m_tx());
+            put(m.m_ty());
+            put(m.m_33());
+            put(obj->opacity(0));
+            return;
+        }
+        putAnimatable(data->mRotation);
+        putAnimatable(data->mScale);
+        putAnimatable(data->mPosition);
+        putAnimatable(data->mAnchor);
+        putAnimatable(data->mOpacity);
+
+        const auto extra = data->mExtra.get();
+        put(uint8_t(extra != nullptr));
+        if (!extra) return;
+
+        putAnimatable(extra->m3DRx);
+        putAnimatable(extra->m3DRy);
+        putAnimatable(extra->m3DRz);
+        putAnimatable(extra->mSeparateX);
+        putAnimatable(extra->mSeparateY);
+        put(uint8_t(extra->mSeparate));
+        put(uint8_t(extra->m3DData));
+    }
+
+    void putContent(const LOTFillData *obj)
+    {
+        put(uint8_t(obj->mFillRule));
+        put(uint8_t(obj->mEnabled));
+        putAnimatable(obj->mColor);
+        putAnimatable(obj->mOpacity);
+    }
+
+    void putContent(const LOTStrokeData *obj)
+    {
+        putAnimatable(obj->mColor);
+        putAnimatable(obj->mOpacity);
+        putAnimatable(obj->mWidth);
+        put(uint8_t(obj->mCapStyle));
+        put(uint8_t(obj->mJoinStyle));
+        put(obj->mMiterLimit);
+        putDash(obj->mDash);
+        put(uint8_t(obj->mEnabled));
+    }
+
+    void putGradient(const LOTGradient *obj)
+    {
+        put(int32_t(obj->mGradientType));
+        putAnimatable(obj->mStartPoint);
+        putAnimatable(obj->mEndPoint);
+        putAnimatable(obj->mHighlightLength);
+        putAnimatable(obj->mHighlightAngle);
+        putAnimatable(obj->mOpacity);
+        putAnimatable(obj->mGradient);
+        put(int32_t(obj->mColorPoints));
+        put(uint8_t(obj->mEnabled));
+    }
+
+    void putContent(const LOTGFillData *obj)
+    {
+        putGradient(obj);
+        put(uint8_t(obj->mFillRule));
+    }
+
+    void putContent(const LOTGStrokeData *obj)
+    {
+        putGradient(obj);
+        putAnimatable(obj->mWidth);
+        put(uint8_t(obj->mCapStyle));
+        put(uint8_t(obj->mJoinStyle));
+        put(obj->mMiterLimit);
+        putDash(obj->mDash);
+    }
+
+    void putContent(const LOTRectData *obj)
+    {
+        put(int32_t(obj->mDirection));
+        putAnimatable(obj->mPos);
+        putAnimatable(obj->mSize);
+        putAnimatable(obj->mRound);
+    }
+
+    void putContent(const LOTEllipseData *obj)
+    {
+        put(int32_t(obj->mDirection));
+        putAnimatable(obj->mPos);
+        putAnimatable(obj->mSize);
+    }
+
+    void putContent(const LOTShapeData *obj)
+    {
+        put(int32_t(obj->mDirection));
+        putAnimatable(obj->mShape);
+    }
+
+    void putContent(const LOTPolystarData *obj)
+    {
+        put(int32_t(obj->mDirection));
+        put(uint8_t(obj->mPolyType));
+        putAnimatable(obj->mPos);
+        putAnimatable(obj->mPointCount);
+        putAnimatable(obj->mInnerRadius);
+        putAnimatable(obj->mOuterRadius);
+        putAnimatable(obj->mInnerRoundness);
+        putAnimatable(obj->mOuterRoundness);
+        putAnimatable(obj->mRotation);
+    }
+
+    void putContent(const LOTTrimData *obj)
+    {
+        putAnimatable(obj->mStart);
+        putAnimatable(obj->mEnd);
+        putAnimatable(obj->mOffset);
+        put(uint8_t(obj->mTrimType));
+    }
+
+    void putContent(const LOTRepeaterData *obj)
+    {
+        putData(obj->mContent.get());
+        putAnimatable(obj->mTransform.mRotation);
+        putAnimatable(obj->mTransform.mScale);
+        putAnimatable(obj->mTransform.mPosition);
+        putAnimatable(obj->mTransform.mAnchor);
+        putAnimatable(obj->mTransform.mStartOpacity);
+        putAnimatable(obj->mTransform.mEndOpacity);
+        putAnimatable(obj->mCopies);
+        putAnimatable(obj->mOffset);
+        put(obj->mMaxCopies);
+    }
+
+private:
+    const LOTCompositionData *                          mComp;
+    std::string &                                       mOut;
+    std::unordered_map<const VInterpolator *, uint32_t> mInterpolators;
+};
+
+/*
+ * Reads the data written by LottieBinaryWriter. All reads are bounds
+ * checked, on any inconsistency the reader stops and read() returns null.
+ */
+class LottieBinaryReader {
+public:
+    LottieBinaryReader(const char *data, size_t size)
+        : mPos(data), mEnd(data + size)
+    {
+    }
+    std::shared_ptr<LOTCompositionData> read()
+    {
+        auto comp = std::make_shared<LOTCompositionData>();
+        mComp = comp.get();
+
+        comp->mVersion = getString();
+        comp->mSize.setWidth(get<int32_t>());
+        comp->mSize.setHeight(get<int32_t>());
+        comp->mStartFrame = long(get<int64_t>());
+        comp->mEndFrame = long(get<int64_t>());
+        comp->mFrameRate = get<float>();
+        comp->mBlendMode =
+            getEnum(LottieBlendMode::Normal, LottieBlendMode::OverLay);
+        comp->setStatic(get<uint8_t>());
+        getMarkers(comp->mMarkers);
+        getMarkers(comp->mLayerInfoList);
+
+        auto count = getCount(1);
+        for (uint32_t i = 0; i < count && !mError; i++) getAsset();
+
+        auto root = getData(0);
+        if (root && root->type() == LOTData::Type::Layer)
+            comp->mRootLayer = std::static_pointer_cast<LOTLayerData>(root);
+
+        if (comp->mRootLayer &&
+            comp->mRootLayer->mLayerType != LayerType::Precomp)
+            mError = true;
+
+        if (mError || !comp->mRootLayer) return nullptr;
+
+        resolveLayerRefs();
+
+        return comp;
+    }
+
+private:
+    bool ensure(size_t size)
+    {
+        if (mError || size_t(mEnd - mPos) < size) mError = true;
+        return !mError;
+    }
+    template <typename T>
+    T get()
+    {
+        T value{};
+        if (ensure(sizeof(T))) {
+            memcpy(&value, mPos, sizeof(T));
+            mPos += sizeof(T);
+        }
+        return value;
+    }
+    // enums are stored as u8, reject the values out of range.
+    template <typename T>
+    T getEnum(T first, T last)
+    {
+        auto value = get<uint8_t>();
+        if (value < uint8_t(first) || value > uint8_t(last)) mError = true;
+        return mError ? first : T(value);
+    }
+    void getBytes(void *data, size_t size)
+    {
+        if (!ensure(size)) return;
+        memcpy(data, mPos, size);
+        mPos += size;
+    }
+    // number of elements that follows, validated against the remaining data.
+    uint32_t getCount(size_t elementSize)
+    {
+        auto count = get<uint32_t>();
+        return ensure(count * elementSize) ? count : 0;
+    }
+    const char *getString()
+    {
+        auto len = get<uint32_t>();
+        if (len == nullString || !ensure(len)) return nullptr;
+
+        const char *str = mPos;
+        mPos += len;
+        return mComp->mStringPool.intern(std::string(str, len));
+    }
+    std::string getStdString()
+    {
+        auto len = getCount(1);
+        std::string str(mPos, len);
+        mPos += len;
+        return str;
+    }
+    void getMarkers(std::vector<Marker> &markers)
+    {
+        auto count = getCount(3 * sizeof(uint32_t));
+        markers.reserve(count);
+        for (uint32_t i = 0; i < count && !mError; i++) {
+            auto name = getStdString();
+            auto start = get<int32_t>();
+            auto end = get<int32_t>();
+            markers.emplace_back(std::move(name), start, end);
+        }
+    }
+
+    void getValue(float &value) { value = get<float>(); }
+    void getValue(VPointF &pt)
+    {
+        pt.setX(get<float>());
+        pt.setY(get<float>());
+    }
+    void getValue(LottieColor &color)
+    {
+        color.r = get<float>();
+        color.g = get<float>();
+        color.b = get<float>();
+    }
+    void getValue(LottieShapeData &shape)
+    {
+        auto count = getCount(sizeof(VPointF));
+        shape.mPoints.resize(count);
+        getBytes(shape.mPoints.data(), count * sizeof(VPointF));
+        shape.mClosed = get<uint8_t>();
+    }
+    void getValue(LottieGradient &gradient)
+    {
+        auto count = getCount(sizeof(float));
+        gradient.mGradient.resize(count);
+        getBytes(gradient.mGradient.data(), count * sizeof(float));
+    }
+
+    template <typename T>
+    void getKeyFrameValue(LOTKeyFrameValue<T> &value)
+    {
+        getValue(value.mStartValue);
+        getValue(value.mEndValue);
+    }
+    void getKeyFrameValue(LOTKeyFrameValue<VPointF> &value)
+    {
+        getValue(value.mStartValue);
+        getValue(value.mEndValue);
+        getValue(value.mInTangent);
+        getValue(value.mOutTangent);
+        value.mPathKeyFrame = get<uint8_t>();
+    }
+
+    std::shared_ptr<VInterpolator> getInterpolator()
+    {
+        auto index = get<uint32_t>();
+        if (index == noInterpolator || mError) return nullptr;
+
+        if (index < mInterpolators.size()) return mInterpolators[index];
+
+        if (index != mInterpolators.size()) {
+            mError = true;
+            return nullptr;
+        }
+
+        VPointF p1, p2;
+        getValue(p1);
+        getValue(p2);
+        mInterpolators.push_back(LOTInterpolatorPool::intern(p1, p2));
+        return mInterpolators.back();
+    }
+
+    template <typename T>
+    void getAnimatable(LOTAnimatable<T> &obj)
+    {
+        if (get<uint8_t>()) return getValue(obj.value());
+
+        // an animated property needs at least one keyframe to be evaluated.
+        auto count = getCount(2 * sizeof(float));
+        if (!count) mError = true;
+        auto &keyFrames = obj.animation().mKeyFrames;
+        keyFrames.resize(count);
+        for (auto &keyFrame : keyFrames) {
+            keyFrame.mStartFrame = get<float>();
+            keyFrame.mEndFrame = get<float>();
+            keyFrame.mInterpolator = getInterpolator();
+            getKeyFrameValue(keyFrame.mValue);
+            if (mError) break;
+            LOTInterpolatorPool::bake(keyFrame);
+            keyFrame.mValue.cacheArcLengths();
+        }
+    }
+
+    void getDash(LOTDashProperty &dash)
+    {
+        auto count = getCount(1);
+        dash.mData.reserve(count);
+        for (uint32_t i = 0; i < count && !mError; i++) {
+            dash.mData.emplace_back();
+            getAnimatable(dash.mData.back());
+        }
+    }
+
+    void getAsset()
+    {
+        auto asset = std::make_shared<LOTAsset>();
+        asset->mAssetType =
+            getEnum(LOTAsset::Type::Precomp, LOTAsset::Type::Char);
+        asset->setStatic(get<uint8_t>());
+        asset->mRefId = getString();
+        auto count = getCount(1);
+        asset->mLayers.reserve(count);
+        for (uint32_t i = 0; i < count && !mError; i++) {
+            auto layer = getData(1);
+            if (!layer || layer->type() != LOTData::Type::Layer) mError = true;
+            asset->mLayers.push_back(std::move(layer));
+        }
+        if (!mError) checkParents(asset->mLayers);
+        asset->mWidth = get<int32_t>();
+        asset->mHeight = get<int32_t>();
+        asset->loadImageData(getStdString());
+        asset->loadImagePath(getStdString());
+
+        mComp->mAssets[asset->mRefId] = std::move(asset);
+    }
+
+    template <typename T>
+    std::shared_ptr<LOTData> create(uint8_t flags, int depth)
+    {
+        auto obj = std::make_shared<T>();
+        obj->setStatic(flags & 1);
+        getContent(obj.get(), depth);
+        return obj;
+    }
+
+    std::shared_ptr<LOTData> getData(int depth)
+    {
+        auto type = get<uint8_t>();
+        if (!type || mError) return nullptr;
+
+        if (depth > maxDepth) {
+            mError = true;
+            return nullptr;
+        }
+
+        auto        flags = get<uint8_t>();
+        const char *name = getString();
+
+        std::shared_ptr<LOTData> obj;
+        switch (LOTData::Type(type)) {
+        case LOTData::Type::Layer:
+            obj = create<LOTLayerData>(flags, depth);
+            break;
+        case LOTData::Type::ShapeGroup:
+            obj = create<LOTShapeGroupData>(flags, depth);
+            break;
+        case LOTData::Type::Transform:
+            obj = create<LOTTransformData>(flags, depth);
+            break;
+        case LOTData::Type::Fill:
+            obj = create<LOTFillData>(flags, depth);
+            break;
+        case LOTData::Type::Stroke:
+            obj = create<LOTStrokeData>(flags, depth);
+            break;
+        case LOTData::Type::GFill:
+            obj = create<LOTGFillData>(flags, depth);
+            break;
+        case LOTData::Type::GStroke:
+            obj = create<LOTGStrokeData>(flags, depth);
+            break;
+        case LOTData::Type::Rect:
+            obj = create<LOTRectData>(flags, depth);
+            break;
+        case LOTData::Type::Ellipse:
+            obj = create<LOTEllipseData>(flags, depth);
+            break;
+        case LOTData::Type::Shape:
+            obj = create<LOTShapeData>(flags, depth);
+            break;
+        case LOTData::Type::Polystar:
+            obj = create<LOTPolystarData>(flags, depth);
+            break;
+        case LOTData::Type::Trim:
+            obj = create<LOTTrimData>(flags, depth);
+            break;
+        case LOTData::Type::Repeater:
+            obj = create<LOTRepeaterData>(flags, depth);
+            break;
+        default:
+            mError = true;
+            return nullptr;
+        }
+
+        obj->setHidden(flags & 2);
+        obj->setName(name, mComp->mStringPool);
+
+        return obj;
+    }
+
+    void getGroup(LOTGroupData *obj, int depth)
+    {
+        auto transform = getData(depth + 1);
+        if (transform) {
+            if (transform->type() == LOTData::Type::Transform)
+                obj->mTransform =
+                    std::static_pointer_cast<LOTTransformData>(transform);
+            else
+                mError = true;
+        }
+
+        auto count = getCount(1);
+        obj->mChildren.reserve(count);
+        for (uint32_t i = 0; i < count && !mError; i++) {
+            // the items and visitors expect every child to exist.
+            auto child = getData(depth + 1);
+            if (!child) mError = true;
+            else obj->mChildren.push_back(std::move(child));
+        }
+    }
+
+    void getContent(LOTShapeGroupData *obj, int depth) { getGroup(obj, depth); }
+
+    // the renderer follows the parents of a layer to build its matrix,
+    // a cycle between them would never end.
+    void checkParents(const std::vector<std::shared_ptr<LOTData>> &layers)
+    {
+        // the same layer LOTCompLayerItem links to when ids repeat.
+        std::unordered_map<int, size_t> index;
+        for (size_t i = 0; i < layers.size(); i++)
+            index[static_cast<LOTLayerData *>(layers[i].get())->id()] = i;
+
+        enum : uint8_t { Unvisited, Visiting, Done };
+        std::vector<uint8_t> state(layers.size(), Unvisited);
+        std::vector<size_t>  chain;
+        for (size_t i = 0; i < layers.size(); i++) {
+            chain.clear();
+            for (size_t current = i; state[current] != Done;) {
+                if (state[current] == Visiting) {
+                    mError = true;
+                    return;
+                }
+                state[current] = Visiting;
+                chain.push_back(current);
+                auto layer = static_cast<LOTLayerData *>(layers[current].get());
+                if (layer->parentId() < 0) break;
+                auto search = index.find(layer->parentId());
+                if (search == index.end()) break;
+                current = search->second;
+            }
+            for (auto layer : chain) state[layer] = Done;
+        }
+    }
+
+    void getContent(LOTLayerData *layer, int depth)
+    {
+        getGroup(layer, depth);
+        layer->mMatteType = getEnum(MatteType::None, MatteType::LumaInv);
+        layer->mLayerType = getEnum(LayerType::Precomp, LayerType::Text);
+        layer->mBlendMode =
+            getEnum(LottieBlendMode::Normal, LottieBlendMode::OverLay);
+        layer->mHasPathOperator = get<uint8_t>();
+        layer->mHasMask = get<uint8_t>();
+        layer->mHasRepeater = get<uint8_t>();
+        layer->mHasGradient = get<uint8_t>();
+        layer->mAutoOrient = get<uint8_t>();
+        layer->mLayerSize.setWidth(get<int32_t>());
+        layer->mLayerSize.setHeight(get<int32_t>());
+        layer->mParentId = get<int32_t>();
+        layer->mId = get<int32_t>();
+        layer->mTimeStreatch = get<float>();
+        layer->mInFrame = get<int32_t>();
+        layer->mOutFrame = get<int32_t>();
+        layer->mStartFrame = get<int32_t>();
+
+        // the renderer expects only layers inside a precomp layer.
+        if (layer->mLayerType == LayerType::Precomp) {
+            for (const auto &child : layer->mChildren)
+                if (!child || child->type() != LOTData::Type::Layer)
+                    mError = true;
+            if (!mError) checkParents(layer->mChildren);
+        }
+
+        if (!get<uint8_t>()) return;
+
+        auto extra = layer->extra();
+        extra->mCompRef = mComp;
+        getValue(extra->mSolidColor);
+        extra->mPreCompRefId = getString();
+        getAnimatable(extra->mTimeRemap);
+        auto count = getCount(1);
+        extra->mMasks.reserve(count);
+        for (uint32_t i = 0; i < count && !mError; i++) {
+            auto mask = std::make_shared<LOTMaskData>();
+            getAnimatable(mask->mShape);
+            getAnimatable(mask->mOpacity);
+            mask->mInv = get<uint8_t>();
+            mask->mIsStatic = get<uint8_t>();
+            mask->mMode = getEnum(LOTMaskData::Mode::None,
+                                  LOTMaskData::Mode::Difference);
+            extra->mMasks.push_back(std::move(mask));
+        }
+
+        if (extra->mPreCompRefId &&
+            (layer->mLayerType == LayerType::Precomp ||
+             layer->mLayerType == LayerType::Image))
+            mLayersToUpdate.push_back(layer);
+    }
+
+    void getContent(LOTTransformData *obj, int)
+    {
+        if (obj->isStatic()) {
+            float m[9];
+            for (auto &elm : m) elm = get<float>();
+            float opacity = get<float>();
+            obj->set(VMatrix(m[0], m[1], m[2], m[3], m[4], m[5], m[6], m[7],
+                             m[8]),
+                     opacity);
+            return;
+        }
+
+        auto data = std::make_unique<TransformData>();
+        getAnimatable(data->mRotation);
+        getAnimatable(data->mScale);
+        getAnimatable(data->mPosition);
+        getAnimatable(data->mAnchor);
+        getAnimatable(data->mOpacity);
+        if (get<uint8_t>()) {
+            data->createExtraData();
+            auto extra = data->mExtra.get();
+            getAnimatable(extra->m3DRx);
+            getAnimatable(extra->m3DRy);
+            getAnimatable(extra->m3DRz);
+            getAnimatable(extra->mSeparateX);
+            getAnimatable(extra->mSeparateY);
+            extra->mSeparate = get<uint8_t>();
+            extra->m3DData = get<uint8_t>();
+        }
+        obj->set(std::move(data), false);
+    }
+
+    void getContent(LOTFillData *obj, int)
+    {
+        obj->mFillRule = getEnum(FillRule::EvenOdd, FillRule::Winding);
+        obj->mEnabled = get<uint8_t>();
+        getAnimatable(obj->mColor);
+        getAnimatable(obj->mOpacity);
+    }
+
+    void getContent(LOTStrokeData *obj, int)
+    {
+        getAnimatable(obj->mColor);
+        getAnimatable(obj->mOpacity);
+        getAnimatable(obj->mWidth);
+        obj->mCapStyle = getEnum(CapStyle::Flat, CapStyle::Round);
+        obj->mJoinStyle = getEnum(JoinStyle::Miter, JoinStyle::Round);
+        obj->mMiterLimit = get<float>();
+        getDash(obj->mDash);
+        obj->mEnabled = get<uint8_t>();
+    }
+
+    void getGradient(LOTGradient *obj)
+    {
+        obj->mGradientType = get<int32_t>();
+        getAnimatable(obj->mStartPoint);
+        getAnimatable(obj->mEndPoint);
+        getAnimatable(obj->mHighlightLength);
+        getAnimatable(obj->mHighlightAngle);
+        getAnimatable(obj->mOpacity);
+        getAnimatable(obj->mGradient);
+        obj->mColorPoints = get<int32_t>();
+        obj->mEnabled = get<uint8_t>();
+
+        // LOTGradient::populate() reads the color and opacity stops without
+        // checking them against the size of the data.
+        if (obj->mGradient.isStatic()) {
+            checkGradient(obj->mGradient.value(), obj->mColorPoints);
+        } else {
+            for (const auto &keyFrame : obj->mGradient.animation().mKeyFrames) {
+                checkGradient(keyFrame.mValue.mStartValue, obj->mColorPoints);
+                checkGradient(keyFrame.mValue.mEndValue, obj->mColorPoints);
+            }
+        }
+    }
+
+    void checkGradient(const LottieGradient &gradient, int colorPoints)
+    {
+        size_t size = gradient.mGradient.size();
+        // legacy bodymovin files only have color stops.
+        size_t colors = colorPoints == -1 ? size / 4 : size_t(colorPoints);
+        if (colorPoints < -1 || !colors || colors > size / 4 ||
+            (size - colors * 4) % 2)
+            mError = true;
+    }
+
+    void getContent(LOTGFillData *obj, int)
+    {
+        getGradient(obj);
+        obj->mFillRule = getEnum(FillRule::EvenOdd, FillRule::Winding);
+    }
+
+    void getContent(LOTGStrokeData *obj, int)
+    {
+        getGradient(obj);
+        getAnimatable(obj->mWidth);
+        obj->mCapStyle = getEnum(CapStyle::Flat, CapStyle::Round);
+        obj->mJoinStyle = getEnum(JoinStyle::Miter, JoinStyle::Round);
+        obj->mMiterLimit = get<float>();
+        getDash(obj->mDash);
+    }
+
+    void getContent(LOTRectData *obj, int)
+    {
+        obj->mDirection = get<int32_t>();
+        getAnimatable(obj->mPos);
+        getAnimatable(obj->mSize);
+        getAnimatable(obj->mRound);
+    }
+
+    void getContent(LOTEllipseData *obj, int)
+    {
+        obj->mDirection = get<int32_t>();
+        getAnimatable(obj->mPos);
+        getAnimatable(obj->mSize);
+    }
+
+    void getContent(LOTShapeData *obj, int)
+    {
+        obj->mDirection = get<int32_t>();
+        getAnimatable(obj->mShape);
+    }
+
+    void getContent(LOTPolystarData *obj, int)
+    {
+        obj->mDirection = get<int32_t>();
+        obj->mPolyType = getEnum(LOTPolystarData::PolyType::Star,
+                                 LOTPolystarData::PolyType::Polygon);
+        getAnimatable(obj->mPos);
+        getAnimatable(obj->mPointCount);
+        getAnimatable(obj->mInnerRadius);
+        getAnimatable(obj->mOuterRadius);
+        getAnimatable(obj->mInnerRoundness);
+        getAnimatable(obj->mOuterRoundness);
+        getAnimatable(obj->mRotation);
+    }
+
+    void getContent(LOTTrimData *obj, int)
+    {
+        getAnimatable(obj->mStart);
+        getAnimatable(obj->mEnd);
+        getAnimatable(obj->mOffset);
+        obj->mTrimType = getEnum(LOTTrimData::TrimType::Simultaneously,
+                                 LOTTrimData::TrimType::Individually);
+    }
+
+    void getContent(LOTRepeaterData *obj, int depth)
+    {
+        auto content = getData(depth + 1);
+        if (content) {
+            if (content->type() == LOTData::Type::ShapeGroup)
+                obj->setContent(
+                    std::static_pointer_cast<LOTShapeGroupData>(content));
+            else
+                mError = true;
+        }
+        getAnimatable(obj->mTransform.mRotation);
+        getAnimatable(obj->mTransform.mScale);
+        getAnimatable(obj->mTransform.mPosition);
+        getAnimatable(obj->mTransform.mAnchor);
+        getAnimatable(obj->mTransform.mStartOpacity);
+        getAnimatable(obj->mTransform.mEndOpacity);
+        getAnimatable(obj->mCopies);
+        getAnimatable(obj->mOffset);
+        obj->mMaxCopies = get<float>();
+    }
+
+    void resolveLayerRefs()
+    {
+        for (auto layer : mLayersToUpdate) {
+            // ref ids are interned so the lookup is by pointer.
+            auto search = mComp->mAssets.find(layer->extra()->mPreCompRefId);
+            if (search == mComp->mAssets.end()) continue;
+
+            if (layer->mLayerType == LayerType::Image)
+                layer->extra()->mAsset = search->second;
+            else
+                layer->mChildren = search->second->mLayers;
+        }
+    }
+
+private:
+    const char *                                mPos;
+    const char *                                mEnd;
+    bool                                        mError{false};
+    LOTCompositionData *                        mComp{nullptr};
+    std::vector<std::shared_ptr<VInterpolator>> mInterpolators;
+    std::vector<LOTLayerData *>                 mLayersToUpdate;
+};
+
+constexpr uint32_t LottieBinary::version;
+
+bool LottieBinary::isBinary(const char *data, size_t size)
+{
+    return data && size >= headerSize && !memcmp(data, magic, sizeof(magic));
+}
+
+void LottieBinary::serialize(const LOTModel &model, std::string &out)
+{
+    out.clear();
+    out.append(magic, sizeof(magic));
+    out.append(reinterpret_cast<const char *>(&version), sizeof(version));
+    out.append(reinterpret_cast<const char *>(&byteOrderMark),
+               sizeof(byteOrderMark));
+
+    LottieBinaryWriter writer(model.mRoot.get(), out);
+    writer.write();
+}
+
+std::shared_ptr<LOTModel> LottieBinary::deserialize(const char *data,
+                                                    size_t      size)
+{
+    if (!isBinary(data, size)) return nullptr;
+
+    uint32_t fileVersion, fileByteOrder;
+    memcpy(&fileVersion, data + sizeof(magic), sizeof(uint32_t));
+    memcpy(&fileByteOrder, data + sizeof(magic) + sizeof(uint32_t),
+           sizeof(uint32_t));
+    if (fileVersion != version || fileByteOrder != byteOrderMark) {
+        vWarning << "unsupported binary model version = " << fileVersion;
+        return nullptr;
+    }
+
+    LottieBinaryReader reader(data + headerSize, size - headerSize);
+    auto               comp = reader.read();
+    if (!comp) {
+        vWarning << "binary model is corrupted";
+        return nullptr;
+    }
+
+    comp->updateStats();
+
+    auto model = std::make_shared<LOTModel>();
+    model->mRoot = std::move(comp);
+    return model;
+}
@@ -0,0 +1,43 @@
+/*
+ * Copyright (c) 2018 Samsung Electronics Co., Ltd. All rights reserved.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA
+ */
+
+#ifndef LOTTIEBINARY_H
+#define LOTTIEBINARY_H
+
+#include "lottiemodel.h"
+#include <memory>
+#include <string>
+
+/*
+ * Versioned binary form of the parsed model.
+ * The model is stored after the parser post processing (precomp linking,
+ * repeater grouping) so loading it back is a linear walk over the data
+ * without any json parsing. The data is in host byte order, a file
+ * written on a different endian machine or by a different version is
+ * rejected.
+ */
+class LottieBinary
+{
+public:
+    static constexpr uint32_t version = 1;
+    static bool isBinary(const char *data, size_t size);
+    static void serialize(const LOTModel &model, std::string &out);
+    static std::shared_ptr<LOTModel> deserialize(const char *data, size_t size);
+};
+
+#endif // LOTTIEBINARY_H
@@ -77,6 +77,14 @@ LOTCompItem::LOTCompItem(LOTModel *model)
     mViewSize = mCompData->size();
 }
 
+size_t LOTCompItem::releaseResources()
+{
+    // force a full update on the next frame request so that
+    // the released data gets recreated.
+    mCurFrameNo = -1;
+    return mRootLayer->releaseResources();
+}
+
 void LOTCompItem::setValue(const std::string &keypath, LOTVariant &value)
 {
     LOTKeyPath key(keypath);
@@ -149,12 +157,8 @@ bool LOTCompItem::render(const rlottie::Surface &surface)
 
     /* schedule all preprocess task for this frame at once.
      */
-    mDrawableList.clear();
-    mRootLayer->renderList(mDrawableList);
     VRect clip(0, 0, int(surface.drawRegionWidth()), int(surface.drawRegionHeight()));
-    for (auto &e : mDrawableList) {
-        e->preprocess(clip);
-    }
+    mRootLayer->preprocess(clip, clip);
 
     mPainter.begin(&mSurface);
     // set sub surface area for drawing.
@@ -199,6 +203,11 @@ VRle LOTMaskItem::rle()
     return mRasterizer.rle();
 }
 
+size_t LOTMaskItem::releaseResources()
+{
+    return mRasterizer.release();
+}
+
 void LOTLayerItem::render(VPainter *painter, const VRle &inheritMask,
                           const VRle &matteRle)
 {
@@ -216,8 +225,10 @@ void LOTLayerItem::render(VPainter *painter, const VRle &inheritMask,
     }
 
     for (auto &i : mDrawableList) {
-        painter->setBrush(i->mBrush);
         VRle rle = i->rle();
+        if (rle.empty()) continue;
+
+        painter->setBrush(i->mBrush);
         if (matteRle.empty()) {
             if (mask.empty()) {
                 // no mask no matte
@@ -304,6 +315,43 @@ VRle LOTLayerMaskItem::maskRle(const VRect &clipRect)
     return mRle;
 }
 
+/*
+ * conservative bounds of maskRle() taken from the mask paths, so it is
+ * known before the masks are rasterized.
+ */
+VRect LOTLayerMaskItem::bounds(const VRect &clipRect) const
+{
+    VRect rect;
+    for (auto &i : mMasks) {
+        VRect box = i.mData->mInv ? clipRect
+                                  : i.mFinalPath.boundingRect().toAlignedRect();
+        switch (i.maskMode()) {
+        case LOTMaskData::Mode::Add:
+        case LOTMaskData::Mode::Difference: {
+            if (rect.empty()) {
+                rect = box;
+            } else if (!box.empty()) {
+                int left = std::min(rect.left(), box.left());
+                int top = std::min(rect.top(), box.top());
+                rect = VRect(left, top,
+                             std::max(rect.right(), box.right()) - left,
+                             std::max(rect.bottom(), box.bottom()) - top);
+            }
+            break;
+        }
+        case LOTMaskData::Mode::Substarct:
+            rect = clipRect;
+            break;
+        case LOTMaskData::Mode::Intersect:
+            rect = box;
+            break;
+        default:
+            break;
+        }
+    }
+    return rect;
+}
+
 LOTLayerItem::LOTLayerItem(LOTLayerData *layerData) : mLayerData(layerData)
 {
     if (mLayerData->mHasMask)
@@ -354,6 +402,29 @@ bool LOTCompLayerItem::resolveKeyPath(LOTKeyPath &keyPath, uint depth,
     return false;
 }
 
+size_t LOTLayerMaskItem::releaseResources()
+{
+    size_t bytes = mRle.memorySize();
+    mRle = VRle();
+    for (auto &i : mMasks) bytes += i.releaseResources();
+    mDirty = true;
+    return bytes;
+}
+
+size_t LOTLayerItem::releaseResources()
+{
+    size_t bytes = 0;
+    if (mRenderBuffer.valid()) {
+        bytes += mRenderBuffer.stride() * mRenderBuffer.height();
+        mRenderBuffer = VBitmap();
+    }
+    if (mLayerMask) bytes += mLayerMask->releaseResources();
+
+    // everything has to be regenerated in the next update.
+    mDirtyFlag = DirtyFlagBit::All;
+    return bytes;
+}
+
 void LOTLayerItem::update(int frameNumber, const VMatrix &parentMatrix,
                           float parentAlpha)
 {
@@ -400,11 +471,37 @@ void LOTLayerItem::update(int frameNumber, const VMatrix &parentMatrix,
     mDirtyFlag = DirtyFlagBit::None;
 }
 
-VMatrix LOTLayerItem::matrix(int frameNo) const
+/*
+ * The matrix of the layer combined with the one of its parent chain. It is
+ * kept for the last frame so that the layers sharing a parent don't evaluate
+ * the transforms of the whole chain again, every layer of the chain is
+ * computed once per frame no matter the order in which the layers update.
+ */
+const VMatrix &LOTLayerItem::matrix(int frameNo) const
+{
+    if (mMatrixFrameNo != frameNo) {
+        mMatrix = mLayerData->matrix(frameNo);
+        if (mParentLayer) mMatrix *= mParentLayer->matrix(frameNo);
+        mMatrixFrameNo = frameNo;
+    }
+    return mMatrix;
+}
+
+void LOTLayerItem::preprocess(const VRect &clip, const VRect &visibleRect)
 {
-    return mParentLayer
-               ? (mLayerData->matrix(frameNo) * mParentLayer->matrix(frameNo))
-               : mLayerData->matrix(frameNo);
+    if (mLayerMask) {
+        preprocessStage(clip, visibleRect & mLayerMask->bounds(clip));
+    } else {
+        preprocessStage(clip, visibleRect);
+    }
+}
+
+void LOTLayerItem::preprocessStage(const VRect &clip, const VRect &visibleRect)
+{
+    mDrawableList.clear();
+    renderList(mDrawableList);
+
+    for (auto &i : mDrawableList) i->preprocess(clip, visibleRect);
 }
 
 bool LOTLayerItem::visible() const
@@ -577,6 +674,21 @@ VRle LOTClipperItem::rle(const VRle& mask)
     return mMaskedRle;
 }
 
+size_t LOTClipperItem::releaseResources()
+{
+    size_t bytes = mMaskedRle.memorySize();
+    mMaskedRle = VRle();
+    return bytes + mRasterizer.release();
+}
+
+size_t LOTCompLayerItem::releaseResources()
+{
+    size_t bytes = LOTLayerItem::releaseResources();
+    if (mClipper) bytes += mClipper->releaseResources();
+    for (const auto &layer : mLayers) bytes += layer->releaseResources();
+    return bytes;
+}
+
 void LOTCompLayerItem::updateContent()
 {
     if (mClipper && flag().testFlag(DirtyFlagBit::Matrix)) {
@@ -590,10 +702,14 @@ void LOTCompLayerItem::updateContent()
     }
 }
 
-void LOTCompLayerItem::renderList(std::vector<VDrawable *> &list)
+void LOTCompLayerItem::preprocessStage(const VRect &clip,
+                                       const VRect &visibleRect)
 {
     if (!visible() || vIsZero(combinedAlpha())) return;
 
+    // nothing outside the precomp area is visible.
+    VRect rect = mClipper ? visibleRect & mClipper->bounds() : visibleRect;
+
     LOTLayerItem *matte = nullptr;
     for (const auto &layer : mLayers) {
         if (layer->hasMatte()) {
@@ -602,11 +718,11 @@ void LOTCompLayerItem::renderList(std::vector<VDrawable *> &list)
             if (layer->visible()) {
                 if (matte) {
                     if (matte->visible()) {
-                        layer->renderList(list);
-                        matte->renderList(list);
+                        layer->preprocess(clip, rect);
+                        matte->preprocess(clip, rect);
                     }
                 } else {
-                    layer->renderList(list);
+                    layer->preprocess(clip, rect);
                 }
             }
             matte = nullptr;
@@ -628,8 +744,7 @@ void LOTSolidLayerItem::updateContent()
                    mLayerData->layerSize().width(),
                    mLayerData->layerSize().height()));
         path.transform(combinedMatrix());
-        mRenderNode.mFlag |= VDrawable::DirtyState::Path;
-        mRenderNode.mPath = path;
+        mRenderNode.setPath(path);
     }
     if (flag() & DirtyFlagBit::Alpha) {
         LottieColor color = mLayerData->solidColor();
@@ -639,6 +754,12 @@ void LOTSolidLayerItem::updateContent()
     }
 }
 
+size_t LOTSolidLayerItem::releaseResources()
+{
+    return LOTLayerItem::releaseResources() +
+           mRenderNode.mRasterizer.release();
+}
+
 void LOTSolidLayerItem::renderList(std::vector<VDrawable *> &list)
 {
     if (!visible() || vIsZero(combinedAlpha())) return;
@@ -649,10 +770,6 @@ void LOTSolidLayerItem::renderList(std::vector<VDrawable *> &list)
 LOTImageLayerItem::LOTImageLayerItem(LOTLayerData *layerData)
     : LOTLayerItem(layerData)
 {
-    if (!mLayerData->asset()) return;
-
-    VBrush brush(mLayerData->asset()->bitmap());
-    mRenderNode.setBrush(brush);
 }
 
 void LOTImageLayerItem::updateContent()
@@ -664,8 +781,7 @@ void LOTImageLayerItem::updateContent()
         path.addRect(VRectF(0, 0, mLayerData->asset()->mWidth,
                             mLayerData->asset()->mHeight));
         path.transform(combinedMatrix());
-        mRenderNode.mFlag |= VDrawable::DirtyState::Path;
-        mRenderNode.mPath = path;
+        mRenderNode.setPath(path);
         mRenderNode.mBrush.setMatrix(combinedMatrix());
     }
 
@@ -674,9 +790,33 @@ void LOTImageLayerItem::updateContent()
     }
 }
 
+size_t LOTImageLayerItem::releaseResources()
+{
+    size_t bytes = LOTLayerItem::releaseResources() +
+                   mRenderNode.mRasterizer.release();
+    // texture will be requested again from the image cache.
+    mRenderNode.setBrush(VBrush());
+    return bytes;
+}
+
 void LOTImageLayerItem::renderList(std::vector<VDrawable *> &list)
 {
-    if (!visible() || vIsZero(combinedAlpha())) return;
+    if (!visible() || vIsZero(combinedAlpha())) {
+        // release the texture so that the decoded image can be
+        // evicted while the layer is not on screen.
+        if (mRenderNode.mBrush.type() == VBrush::Type::Texture)
+            mRenderNode.setBrush(VBrush());
+        return;
+    }
+
+    if (!mLayerData->asset()) return;
+
+    // decode the image lazily on first use.
+    if (mRenderNode.mBrush.type() != VBrush::Type::Texture) {
+        mRenderNode.setBrush(VBrush(mLayerData->asset()->bitmap()));
+        mRenderNode.mBrush.setMatrix(combinedMatrix());
+        if (mRenderNode.mBrush.type() != VBrush::Type::Texture) return;
+    }
 
     list.push_back(&mRenderNode);
 }
@@ -765,6 +905,11 @@ void LOTShapeLayerItem::updateContent()
     }
 }
 
+size_t LOTShapeLayerItem::releaseResources()
+{
+    return LOTLayerItem::releaseResources() + mRoot->releaseResources();
+}
+
 void LOTShapeLayerItem::renderList(std::vector<VDrawable *> &list)
 {
     if (!visible() || vIsZero(combinedAlpha())) return;
@@ -897,6 +1042,13 @@ void LOTContentGroupItem::applyTrim()
     }
 }
 
+size_t LOTContentGroupItem::releaseResources()
+{
+    size_t bytes = 0;
+    for (const auto &content : mContents) bytes += content->releaseResources();
+    return bytes;
+}
+
 void LOTContentGroupItem::renderList(std::vector<VDrawable *> &list)
 {
     for (const auto &content : mContents) {
@@ -931,6 +1083,85 @@ void LOTContentGroupItem::processPaintItems(
     }
 }
 
+/*
+ * pairs the paint items of the group with the ones at the same place in
+ * the source group of the same content. The copies of a nested repeater
+ * that were not created in the source yet have no pair.
+ */
+void LOTContentGroupItem::paintItems(const LOTContentGroupItem *source,
+                                     std::vector<PaintPair> &   list) const
+{
+    for (size_t i = 0; i < mContents.size(); i++) {
+        auto content = mContents[i].get();
+        auto other = source && i < source->mContents.size()
+                         ? source->mContents[i].get()
+                         : nullptr;
+        switch (content->type()) {
+        case ContentType::Paint:
+            list.emplace_back(static_cast<LOTPaintDataItem *>(other),
+                              static_cast<LOTPaintDataItem *>(content));
+            break;
+        case ContentType::Group:
+            static_cast<LOTContentGroupItem *>(content)->paintItems(
+                static_cast<LOTContentGroupItem *>(other), list);
+            break;
+        default:
+            break;
+        }
+    }
+}
+
+/*
+ * the first path item of the group in the order processPaintItems()
+ * collects them.
+ */
+LOTPathDataItem *LOTContentGroupItem::firstPathItem() const
+{
+    for (auto i = mContents.rbegin(); i != mContents.rend(); ++i) {
+        auto content = (*i).get();
+        switch (content->type()) {
+        case ContentType::Path:
+            return static_cast<LOTPathDataItem *>(content);
+        case ContentType::Group: {
+            auto item = static_cast<LOTContentGroupItem *>(content)->firstPathItem();
+            if (item) return item;
+            break;
+        }
+        default:
+            break;
+        }
+    }
+    return nullptr;
+}
+
+/*
+ * adds the path items of a repeater copy created after the layer was
+ * built to the paint and trim items of this group and its parents that
+ * draw the path items of the copy before it, where processPaintItems()
+ * and processTrimItems() would have put them.
+ */
+void LOTContentGroupItem::insertPathItems(
+    LOTPathDataItem *before, const std::vector<LOTPathDataItem *> &list)
+{
+    for (const auto &content : mContents) {
+        switch (content->type()) {
+        case ContentType::Paint:
+            static_cast<LOTPaintDataItem *>(content.get())
+                ->insertPathItems(before, list);
+            break;
+        case ContentType::Trim:
+            static_cast<LOTTrimItem *>(content.get())
+                ->insertPathItems(before, list);
+            break;
+        default:
+            break;
+        }
+    }
+    if (parent())
+        static_cast<LOTContentGroupItem *>(parent())->insertPathItems(before,
+                                                                      list);
+}
+
 void LOTContentGroupItem::processTrimItems(std::vector<LOTPathDataItem *> &list)
 {
     size_t curOpCount = list.size();
@@ -982,6 +1213,7 @@ void LOTPathDataItem::update(int              frameNo, const VMatrix &, float,
         updatePath(mLocalPath, frameNo);
         mPathChanged = true;
         mNeedUpdate = true;
+        mRevision++;
     }
     // 2. keep a reference path in temp in case there is some
     // path operation like trim which will update the path.
@@ -998,12 +1230,16 @@ const VPath &LOTPathDataItem::finalPath()
 {
     if (mPathChanged || mNeedUpdate) {
         mFinalPath.clone(mTemp);
-        mFinalPath.transform(
-            static_cast<LOTContentGroupItem *>(parent())->matrix());
+        mFinalPath.transform(matrix());
         mNeedUpdate = false;
     }
     return mFinalPath;
 }
+
+const VMatrix &LOTPathDataItem::matrix() const
+{
+    return static_cast<LOTContentGroupItem *>(parent())->matrix();
+}
 LOTRectItem::LOTRectItem(LOTRectData *data)
     : LOTPathDataItem(data->isStatic()), mData(data)
 {
@@ -1111,16 +1347,70 @@ void LOTPaintDataItem::updateRenderNode()
     if (dirty) {
         mPath.reset();
 
+        // path items of the same group share the matrix, their local paths
+        // are mapped by the rasterizer while it converts the points.
+        const VMatrix &matrix = mPathItems.front()->matrix();
+        bool           local = std::all_of(
+            mPathItems.begin(), mPathItems.end(),
+            [&matrix](LOTPathDataItem *i) { return &i->matrix() == &matrix; });
         for (auto &i : mPathItems) {
-            mPath.addPath(i->finalPath());
+            mPath.addPath(local ? i->localPath() : i->finalPath());
         }
-        mDrawable.setPath(mPath);
+        VMatrix m = local ? matrix : VMatrix();
+        VPointF offset;
+        if (translated(offset))
+            mDrawable.setPath(mPath, m, offset);
+        else
+            mDrawable.setPath(mPath, m);
     } else {
         if (mDrawable.mFlag & VDrawable::DirtyState::Path)
             mDrawable.mPath = mPath;
     }
 }
 
+/*
+ * checks whether the path items only moved since the drawable path was
+ * built last time, which is the case when none of the local paths
+ * changed and all the matrices differ by the same translation.
+ */
+bool LOTPaintDataItem::translated(VPointF &offset)
+{
+    bool moved =
+        !mPathItems.empty() && mPathStates.size() == mPathItems.size();
+    mPathStates.resize(mPathItems.size());
+    for (size_t i = 0; i < mPathItems.size(); i++) {
+        const VMatrix &m = mPathItems[i]->matrix();
+        uint           revision = mPathItems[i]->revision();
+        PathState &    state = mPathStates[i];
+        if (moved) {
+            VPointF delta(m.m_tx() - state.matrix.m_tx(),
+                          m.m_ty() - state.matrix.m_ty());
+            bool sameDelta =
+                i == 0 || (delta.x() == offset.x() && delta.y() == offset.y());
+            moved = sameDelta && state.revision == revision &&
+                    m.isTranslationOf(state.matrix);
+            offset = delta;
+        }
+        state.matrix = m;
+        state.revision = revision;
+    }
+    return moved;
+}
+
+bool LOTPaintDataItem::trimmed() const
+{
+    return std::any_of(mPathItems.begin(), mPathItems.end(),
+                       [](const LOTPathDataItem *i) { return i->trimmed(); });
+}
+
+size_t LOTPaintDataItem::releaseResources()
+{
+    // there is no rle left to move, the path has to be rasterized again.
+    mDrawable.mMovable = false;
+    mPathStates.clear();
+    return mDrawable.mRasterizer.release();
+}
+
 void LOTPaintDataItem::renderList(std::vector<VDrawable *> &list)
 {
     if (mRenderNodeUpdate) {
@@ -1138,6 +1428,13 @@ void LOTPaintDataItem::addPathItems(std::vector<LOTPathDataItem *> &list,
               back_inserter(mPathItems));
 }
 
+void LOTPaintDataItem::insertPathItems(
+    LOTPathDataItem *before, const std::vector<LOTPathDataItem *> &list)
+{
+    auto it = std::find(mPathItems.begin(), mPathItems.end(), before);
+    if (it != mPathItems.end()) mPathItems.insert(it, list.begin(), list.end());
+}
+
 LOTFillItem::LOTFillItem(LOTFillData *data)
     : LOTPaintDataItem(data->isStatic()), mModel(data)
 {
@@ -1327,6 +1624,18 @@ void LOTTrimItem::addPathItems(std::vector<LOTPathDataItem *> &list,
 {
     std::copy(list.begin() + startOffset, list.end(),
               back_inserter(mPathItems));
+    for (auto i = list.begin() + startOffset; i != list.end(); ++i)
+        (*i)->setTrimmed();
+}
+
+void LOTTrimItem::insertPathItems(LOTPathDataItem *                     before,
+                                  const std::vector<LOTPathDataItem *> &list)
+{
+    auto it = std::find(mPathItems.begin(), mPathItems.end(), before);
+    if (it == mPathItems.end()) return;
+
+    mPathItems.insert(it, list.begin(), list.end());
+    for (auto i : list) i->setTrimmed();
 }
 
 LOTRepeaterItem::LOTRepeaterItem(LOTRepeaterData *data) : mRepeaterData(data)
@@ -1335,12 +1644,54 @@ LOTRepeaterItem::LOTRepeaterItem(LOTRepeaterData *data) : mRepeaterData(data)
 
     mCopies = mRepeaterData->maxCopies();
 
-    for (int i = 0; i < mCopies; i++) {
-        auto content =
-            std::make_unique<LOTContentGroupItem>(mRepeaterData->content());
-        content->setParent(this);
-        mContents.push_back(std::move(content));
+    // the layer wires the first copy, the others are created the first
+    // time they are visible.
+    if (mCopies > 0) addCopy();
+}
+
+void LOTRepeaterItem::addCopy()
+{
+    auto content =
+        std::make_unique<LOTContentGroupItem>(mRepeaterData->content());
+    content->setParent(this);
+
+    if (!mContents.empty()) {
+        std::vector<LOTPathDataItem *> list;
+        content->processPaintItems(list);
+        list.clear();
+        content->processTrimItems(list);
+
+        // the copy is collected before the last one.
+        auto before = copyItem(int(mContents.size()) - 1)->firstPathItem();
+        if (before && !list.empty()) insertPathItems(before, list);
+
+        for (auto &i : mValues)
+            content->resolveKeyPath(i.keyPath, i.depth, i.value);
+    }
+    mContents.push_back(std::move(content));
+
+    if (int(mContents.size()) == mCopies) mValues.clear();
+}
+
+/*
+ * the values are kept for the copies that are not created yet, a value
+ * set again for the same keypath replaces the earlier one.
+ */
+bool LOTRepeaterItem::resolveKeyPath(LOTKeyPath &keyPath, uint depth,
+                                     LOTVariant &value)
+{
+    if (int(mContents.size()) < mCopies) {
+        mValues.erase(std::remove_if(mValues.begin(), mValues.end(),
+                                     [&](const KeyPathValue &i) {
+                                         return i.keyPath == keyPath &&
+                                                i.depth == depth &&
+                                                i.value.property() ==
+                                                    value.property();
+                                     }),
+                      mValues.end());
+        mValues.push_back({keyPath, depth, value});
     }
+    return LOTContentGroupItem::resolveKeyPath(keyPath, depth, value);
 }
 
 void LOTRepeaterItem::update(int frameNo, const VMatrix &parentMatrix,
@@ -1349,15 +1700,18 @@ void LOTRepeaterItem::update(int frameNo, const VMatrix &parentMatrix,
     DirtyFlag newFlag = flag;
 
     float copies = mRepeaterData->copies(frameNo);
-    int   visibleCopies = int(copies);
+    int   visibleCopies = std::min(int(copies), mCopies);
 
-    if (visibleCopies == 0) {
+    if (visibleCopies <= 0) {
         mHidden = true;
+        mVisibleCopies = 0;
         return;
     }
 
     mHidden = false;
 
+    while (int(mContents.size()) < visibleCopies) addCopy();
+
     if (!mRepeaterData->isStatic()) newFlag |= DirtyFlagBit::Matrix;
 
     float offset = mRepeaterData->offset(frameNo);
@@ -1366,21 +1720,69 @@ void LOTRepeaterItem::update(int frameNo, const VMatrix &parentMatrix,
 
     newFlag |= DirtyFlagBit::Alpha;
 
-    for (int i = 0; i < mCopies; ++i) {
+    mPaintItems.clear();
+    copyItem(0)->paintItems(nullptr, mPaintItems);
+    for (auto &i : mPaintItems) i.second->drawable().mShared = false;
+
+    // only the visible copies are updated and rendered, the ones that
+    // were hidden in the last frame missed the updates in between.
+    VMatrix first;
+    for (int i = 0; i < visibleCopies; ++i) {
         float newAlpha =
             parentAlpha * lerp(startOpacity, endOpacity, i / copies);
 
-        // hide rest of the copies , @TODO find a better solution.
-        if (i >= visibleCopies) newAlpha = 0;
-
         VMatrix result = mRepeaterData->mTransform.matrix(frameNo, i + offset) *
                          parentMatrix;
-        mContents[i]->update(frameNo, result, newAlpha, newFlag);
+        mContents[i]->update(frameNo, result, newAlpha,
+                             i < mVisibleCopies ? newFlag
+                                                : DirtyFlag(DirtyFlagBit::All));
+        if (i == 0)
+            first = result;
+        else
+            shareRle(i, first, result);
+    }
+    mVisibleCopies = visibleCopies;
+}
+
+/*
+ * a copy whose matrix only differs from the first copy by a whole pixel
+ * translation draws the same pixels moved, so it reuses the rle of the
+ * first copy. Like the rle reuse between frames it has to be exactly
+ * whole pixels, any fraction moves the points against the 1/64 pixel
+ * grid of the raster. Trimmed paths can differ between the copies.
+ */
+void LOTRepeaterItem::shareRle(int copy, const VMatrix &first,
+                               const VMatrix &matrix)
+{
+    float dx = matrix.m_tx() - first.m_tx();
+    float dy = matrix.m_ty() - first.m_ty();
+    bool  translated = matrix.isTranslationOf(first) &&
+                      dx == std::round(dx) && dy == std::round(dy);
+    VPoint offset(int(std::round(dx)), int(std::round(dy)));
+
+    mPaintItems.clear();
+    copyItem(copy)->paintItems(copyItem(0), mPaintItems);
+    for (auto &i : mPaintItems) {
+        LOTPaintDataItem *paint = i.second;
+        if (!translated || !i.first || i.first->trimmed()) {
+            paint->drawable().setSource(nullptr, {});
+            continue;
+        }
+        // a nested repeater may have made the source a copy as well.
+        VDrawable *source = &i.first->drawable();
+        VPoint     sourceOffset = offset;
+        while (source->mSource) {
+            sourceOffset += source->mOffset;
+            source = source->mSource;
+        }
+        paint->drawable().setSource(source, sourceOffset);
+        source->mShared = true;
     }
 }
 
 void LOTRepeaterItem::renderList(std::vector<VDrawable *> &list)
 {
     if (mHidden) return;
-    return LOTContentGroupItem::renderList(list);
+
+    for (int i = 0; i < mVisibleCopies; i++) mContents[i]->renderList(list);
 }
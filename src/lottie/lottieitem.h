@@ -21,6 +21,7 @@
 
 #include<sstream>
 #include<memory>
+#include<limits>
 
 #include"lottieproxymodel.h"
 #include"vmatrix.h"
@@ -53,11 +54,12 @@ public:
     void sync();
 public:
     std::unique_ptr<LOTNode>  mCNode{nullptr};
-
-    ~LOTDrawable() {
-        if (mCNode && mCNode->mGradient.stopPtr)
-          free(mCNode->mGradient.stopPtr);
-    }
+    // storage the render tree node points into, stays valid
+    // till the next sync.
+    std::vector<LOTGradientStop> mCStops;
+    std::vector<float>           mCDash;
+    VPath                        mCPath;
+    VPath                        mCDashedPath;
 };
 
 class LOTCompItem
@@ -71,6 +73,7 @@ public:
    const LOTLayerNode * renderTree()const;
    bool render(const rlottie::Surface &surface);
    void setValue(const std::string &keypath, LOTVariant &value);
+   size_t releaseResources();
 private:
    VPainter                                    mPainter;
    VBitmap                                     mSurface;
@@ -81,7 +84,6 @@ private:
    bool                                        mKeepAspectRatio{true};
    int                                         mCurFrameNo;
    std::vector<LOTNode *>                      mRenderList;
-   std::vector<VDrawable *>                    mDrawableList;
 };
 
 class LOTLayerMaskItem;
@@ -92,6 +94,8 @@ public:
     explicit LOTClipperItem(VSize size): mSize(size){}
     void update(const VMatrix &matrix);
     VRle rle(const VRle& mask);
+    VRect bounds() const { return mPath.boundingRect().toAlignedRect(); }
+    size_t releaseResources();
 public:
     VSize                    mSize;
     VPath                    mPath;
@@ -122,8 +126,13 @@ public:
    void setComplexContent(bool value) { mComplexContent = value;}
    bool complexContent() const {return mComplexContent;}
    virtual void update(int frameNo, const VMatrix &parentMatrix, float parentAlpha);
-   VMatrix matrix(int frameNo) const;
+   const VMatrix &matrix(int frameNo) const;
    virtual void renderList(std::vector<VDrawable *> &){}
+   /*
+    * schedules the rasterization of the drawables which can be seen
+    * inside visibleRect, the rest are culled for this frame.
+    */
+   void preprocess(const VRect &clip, const VRect &visibleRect);
    virtual void render(VPainter *painter, const VRle &mask, const VRle &matteRle);
    bool hasMatte() { if (mLayerData->mMatteType == MatteType::None) return false; return true; }
    MatteType matteType() const { return mLayerData->mMatteType;}
@@ -135,9 +144,15 @@ public:
    std::vector<LOTNode *>& cnodes() {return mCApiData->mCNodeList;}
    const char* name() const {return mLayerData->name();}
    virtual bool resolveKeyPath(LOTKeyPath &keyPath, uint depth, LOTVariant &value);
+   /*
+    * drops the rasterized data and render buffers, they will be
+    * recreated by the next update. returns the number of bytes freed.
+    */
+   virtual size_t releaseResources();
    VBitmap& bitmap() {return mRenderBuffer;}
 protected:
    virtual void updateContent() = 0;
+   virtual void preprocessStage(const VRect &clip, const VRect &visibleRect);
    inline VMatrix combinedMatrix() const {return mCombinedMatrix;}
    inline int frameNo() const {return mFrameNo;}
    inline float combinedAlpha() const {return mCombinedAlpha;}
@@ -150,6 +165,8 @@ protected:
    LOTLayerData                               *mLayerData{nullptr};
    LOTLayerItem                               *mParentLayer{nullptr};
    VMatrix                                     mCombinedMatrix;
+   mutable VMatrix                             mMatrix;
+   mutable int                                 mMatrixFrameNo{std::numeric_limits<int>::min()};
    VBitmap                                     mRenderBuffer;
    float                                       mCombinedAlpha{0.0};
    int                                         mFrameNo{-1};
@@ -162,12 +179,13 @@ class LOTCompLayerItem: public LOTLayerItem
 {
 public:
    explicit LOTCompLayerItem(LOTLayerData *layerData);
-   void renderList(std::vector<VDrawable *> &list)final;
    void render(VPainter *painter, const VRle &mask, const VRle &matteRle) final;
    void buildLayerNode() final;
    bool resolveKeyPath(LOTKeyPath &keyPath, uint depth, LOTVariant &value) override;
+   size_t releaseResources() final;
 protected:
    void updateContent() final;
+   void preprocessStage(const VRect &clip, const VRect &visibleRect) final;
 private:
     void renderHelper(VPainter *painter, const VRle &mask, const VRle &matteRle);
     void renderMatteLayer(VPainter *painter, const VRle &inheritMask, const VRle &matteRle,
@@ -182,6 +200,7 @@ class LOTSolidLayerItem: public LOTLayerItem
 public:
    explicit LOTSolidLayerItem(LOTLayerData *layerData);
    void buildLayerNode() final;
+   size_t releaseResources() final;
 protected:
    void updateContent() final;
    void renderList(std::vector<VDrawable *> &list) final;
@@ -199,6 +218,7 @@ public:
    void renderList(std::vector<VDrawable *> &list)final;
    void buildLayerNode() final;
    bool resolveKeyPath(LOTKeyPath &keyPath, uint depth, LOTVariant &value) override;
+   size_t releaseResources() final;
 protected:
    void updateContent() final;
    std::unique_ptr<LOTContentGroupItem> mRoot;
@@ -217,6 +237,7 @@ class LOTImageLayerItem: public LOTLayerItem
 public:
    explicit LOTImageLayerItem(LOTLayerData *layerData);
    void buildLayerNode() final;
+   size_t releaseResources() final;
 protected:
    void updateContent() final;
    void renderList(std::vector<VDrawable *> &list) final;
@@ -231,6 +252,7 @@ public:
     void update(int frameNo, const VMatrix &parentMatrix, float parentAlpha, const DirtyFlag &flag);
     LOTMaskData::Mode maskMode() const { return mData->mMode;}
     VRle rle();
+    size_t releaseResources();
 public:
     LOTMaskData             *mData;
     float                    mCombinedAlpha{0};
@@ -251,6 +273,8 @@ public:
     void update(int frameNo, const VMatrix &parentMatrix, float parentAlpha, const DirtyFlag &flag);
     bool isStatic() const {return mStatic;}
     VRle maskRle(const VRect &clipRect);
+    VRect bounds(const VRect &clipRect) const;
+    size_t releaseResources();
 public:
     std::vector<LOTMaskItem>   mMasks;
     VRle                       mRle;
@@ -282,6 +306,7 @@ public:
    void setParent(LOTContentItem *parent) {mParent = parent;}
    LOTContentItem *parent() const {return mParent;}
    virtual bool resolveKeyPath(LOTKeyPath &, uint, LOTVariant &) {return false;}
+   virtual size_t releaseResources() {return 0;}
    ContentType type() const {return mType;}
 private:
    ContentType     mType{ContentType::Unknown};
@@ -297,8 +322,13 @@ public:
    void applyTrim();
    void processTrimItems(std::vector<LOTPathDataItem *> &list);
    void processPaintItems(std::vector<LOTPathDataItem *> &list);
+   using PaintPair = std::pair<LOTPaintDataItem *, LOTPaintDataItem *>;
+   void paintItems(const LOTContentGroupItem *source, std::vector<PaintPair> &list) const;
+   LOTPathDataItem *firstPathItem() const;
+   void insertPathItems(LOTPathDataItem *before, const std::vector<LOTPathDataItem *> &list);
    void renderList(std::vector<VDrawable *> &list) override;
    const VMatrix & matrix() const { return mMatrix;}
+   size_t releaseResources() override;
    const char* name() const
    {
        static const char* TAG = "__";
@@ -319,8 +349,12 @@ public:
    bool dirty() const {return mPathChanged;}
    const VPath &localPath() const {return mTemp;}
    const VPath &finalPath();
-   void updatePath(const VPath &path) {mTemp = path; mPathChanged = true; mNeedUpdate = true;}
+   const VMatrix &matrix() const;
+   uint revision() const {return mRevision;}
+   void updatePath(const VPath &path) {mTemp = path; mPathChanged = true; mNeedUpdate = true; mRevision++;}
    bool staticPath() const { return mStaticPath; }
+   void setTrimmed() { mTrimmed = true; }
+   bool trimmed() const { return mTrimmed; }
 protected:
    virtual void updatePath(VPath& path, int frameNo) = 0;
    virtual bool hasChanged(int prevFrame, int curFrame) = 0;
@@ -337,9 +371,11 @@ private:
    VPath                                   mTemp;
    VPath                                   mFinalPath;
    int                                     mFrameNo{-1};
+   uint                                    mRevision{0};
    bool                                    mPathChanged{true};
    bool                                    mNeedUpdate{true};
    bool                                    mStaticPath;
+   bool                                    mTrimmed{false};
 };
 
 class LOTRectItem: public LOTPathDataItem
@@ -408,14 +444,25 @@ class LOTPaintDataItem : public LOTContentItem
 public:
    LOTPaintDataItem(bool staticContent);
    void addPathItems(std::vector<LOTPathDataItem *> &list, size_t startOffset);
+   void insertPathItems(LOTPathDataItem *before, const std::vector<LOTPathDataItem *> &list);
    void update(int frameNo, const VMatrix &parentMatrix, float parentAlpha, const DirtyFlag &flag) override;
    void renderList(std::vector<VDrawable *> &list) final;
+   size_t releaseResources() final;
+   VDrawable &drawable() { return mDrawable; }
+   bool trimmed() const;
 protected:
    virtual void updateContent(int frameNo) = 0;
    virtual void updateRenderNode();
    inline float parentAlpha() const {return mParentAlpha;}
+private:
+   bool translated(VPointF &offset);
+   struct PathState {
+       VMatrix matrix;
+       uint    revision{0};
+   };
 protected:
    std::vector<LOTPathDataItem *>   mPathItems;
+   std::vector<PathState>           mPathStates;
    LOTDrawable                      mDrawable;
    VPath                            mPath;
    float                            mParentAlpha{1.0f};
@@ -496,6 +543,7 @@ public:
    void update(int frameNo, const VMatrix &parentMatrix, float parentAlpha, const DirtyFlag &flag) final;
    void update();
    void addPathItems(std::vector<LOTPathDataItem *> &list, size_t startOffset);
+   void insertPathItems(LOTPathDataItem *before, const std::vector<LOTPathDataItem *> &list);
 private:
    bool pathDirty() const {
        for (auto &i : mPathItems) {
@@ -521,10 +569,25 @@ public:
    explicit LOTRepeaterItem(LOTRepeaterData *data);
    void update(int frameNo, const VMatrix &parentMatrix, float parentAlpha, const DirtyFlag &flag) final;
    void renderList(std::vector<VDrawable *> &list) final;
+   bool resolveKeyPath(LOTKeyPath &keyPath, uint depth, LOTVariant &value) final;
+private:
+   void addCopy();
+   LOTContentGroupItem *copyItem(int i) const {
+       return static_cast<LOTContentGroupItem *>(mContents[size_t(i)].get());
+   }
+   void shareRle(int copy, const VMatrix &first, const VMatrix &matrix);
+   struct KeyPathValue {
+       LOTKeyPath keyPath;
+       uint       depth;
+       LOTVariant value;
+   };
 private:
-   LOTRepeaterData             *mRepeaterData;
-   bool                         mHidden{false};
-   int                          mCopies{0};
+   LOTRepeaterData                           *mRepeaterData;
+   std::vector<PaintPair>                     mPaintItems;
+   std::vector<KeyPathValue>                  mValues;
+   bool                                       mHidden{false};
+   int                                        mCopies{0};
+   int                                        mVisibleCopies{0};
 };
 
 
@@ -202,16 +202,12 @@ void LOTImageLayerItem::buildLayerNode()
     clayer().mNodeList.size = cnodes().size();
 }
 
-static void updateGStops(LOTNode *n, const VGradient *grad)
+static void updateGStops(LOTNode *n, std::vector<LOTGradientStop> &stops,
+                         const VGradient *grad)
 {
-    if (grad->mStops.size() != n->mGradient.stopCount) {
-        if (n->mGradient.stopCount) free(n->mGradient.stopPtr);
-        n->mGradient.stopCount = grad->mStops.size();
-        n->mGradient.stopPtr = (LOTGradientStop *)malloc(
-            n->mGradient.stopCount * sizeof(LOTGradientStop));
-    }
+    stops.resize(grad->mStops.size());
 
-    LOTGradientStop *ptr = n->mGradient.stopPtr;
+    LOTGradientStop *ptr = stops.data();
     for (const auto &i : grad->mStops) {
         ptr->pos = i.first;
         ptr->a = uchar(i.second.alpha() * grad->alpha());
@@ -220,6 +216,20 @@ static void updateGStops(LOTNode *n, const VGradient *grad)
         ptr->b = i.second.blue();
         ptr++;
     }
+    n->mGradient.stopPtr = stops.data();
+    n->mGradient.stopCount = stops.size();
+}
+
+/*
+ * VPath is copy on write so the data is still shared with the
+ * last synced path unless it has been modified in between.
+ */
+static bool samePath(const VPath &a, const VPath &b)
+{
+    return a.elements().data() == b.elements().data() &&
+           a.elements().size() == b.elements().size() &&
+           a.points().data() == b.points().data() &&
+           a.points().size() == b.points().size();
 }
 
 void LOTDrawable::sync()
@@ -233,13 +243,22 @@ void LOTDrawable::sync()
     mCNode->mFlag = ChangeFlagNone;
     if (mFlag & DirtyState::None) return;
 
-    if (mFlag & DirtyState::Path) {
-        if (!mStroke.mDash.empty()) {
-            VDasher dasher(mStroke.mDash.data(), mStroke.mDash.size());
-            mPath = dasher.dashed(mPath);
+    // a path drawn with a matrix is exposed in device co-ordinates, so
+    // it can't be compared to the last one by the shared data.
+    if ((mFlag & DirtyState::Path) &&
+        (!mMatrix.isIdentity() || !samePath(mPath, mCPath) ||
+         mStroke.mDash != mCDash)) {
+        mCPath = mPath;
+        if (!mMatrix.isIdentity()) mCPath.transform(mMatrix);
+        mCDash = mStroke.mDash;
+        const VPath *path = &mCPath;
+        if (!mCDash.empty()) {
+            VDasher dasher(mCDash.data(), mCDash.size());
+            mCDashedPath = dasher.dashed(mCPath);
+            path = &mCDashedPath;
         }
-        const std::vector<VPath::Element> &elm = mPath.elements();
-        const std::vector<VPointF> &       pts = mPath.points();
+        const std::vector<VPath::Element> &elm = path->elements();
+        const std::vector<VPointF> &       pts = path->points();
         const float *ptPtr = reinterpret_cast<const float *>(pts.data());
         const char * elmPtr = reinterpret_cast<const char *>(elm.data());
         mCNode->mPath.elmPtr = elmPtr;
@@ -312,7 +331,7 @@ void LOTDrawable::sync()
         mCNode->mGradient.start.y = s.y();
         mCNode->mGradient.end.x = e.x();
         mCNode->mGradient.end.y = e.y();
-        updateGStops(mCNode.get(), mBrush.mGradient);
+        updateGStops(mCNode.get(), mCStops, mBrush.mGradient);
         break;
     }
     case VBrush::Type::RadialGradient: {
@@ -330,7 +349,7 @@ void LOTDrawable::sync()
         float scale = mBrush.mGradient->mMatrix.scale();
         mCNode->mGradient.cradius = mBrush.mGradient->radial.cradius * scale;
         mCNode->mGradient.fradius = mBrush.mGradient->radial.fradius * scale;
-        updateGStops(mCNode.get(), mBrush.mGradient);
+        updateGStops(mCNode.get(), mCStops, mBrush.mGradient);
         break;
     }
     default:
@@ -34,6 +34,7 @@ public:
         return skip(key) ? true : (depth < size()) || (mKeys[depth] == "**");
     }
     bool skip(const std::string &key) const { return key == "__";}
+    bool operator==(const LOTKeyPath &other) const { return mKeys == other.mKeys;}
 private:
     bool isGlobstar(uint depth) const {return mKeys[depth] == "**";}
     bool isGlob(uint depth) const {return mKeys[depth] == "*";}
@@ -17,11 +17,28 @@
  */
 
 #include "lottieloader.h"
+#include "lottiebinary.h"
 #include "lottieparser.h"
+#include "lottietaskscheduler.h"
 
 #include <cstring>
 #include <fstream>
 
+#ifdef LOTTIE_THREAD_SUPPORT
+#include <future>
+#include <mutex>
+#include <unordered_map>
+#endif
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#else
+#include <iterator>
+#endif
+
 #ifdef LOTTIE_CACHE_SUPPORT
 
 #include <unordered_map>
@@ -66,6 +83,18 @@ public:
         if (!mcacheSize) mHash.clear();
     }
 
+    // drop the models which are not used by any animation.
+    void releaseUnused()
+    {
+        std::lock_guard<std::mutex> guard(mMutex);
+        for (auto it = mHash.begin(); it != mHash.end();) {
+            if (it->second.use_count() == 1)
+                it = mHash.erase(it);
+            else
+                ++it;
+        }
+    }
+
 private:
     LottieModelCache() = default;
 
@@ -86,15 +115,203 @@ public:
     std::shared_ptr<LOTModel> find(const std::string &) { return nullptr; }
     void add(const std::string &, std::shared_ptr<LOTModel>) {}
     void configureCacheSize(size_t) {}
+    void releaseUnused() {}
 };
 
 #endif
 
+#ifdef LOTTIE_THREAD_SUPPORT
+
+/*
+ * Models which are being parsed right now, so that concurrent loads of
+ * the same key wait for the first one instead of parsing it again.
+ * Synchronous loads block on the shared result, asynchronous ones leave
+ * a waiter that is run on the pool once the result is published so that
+ * they don't hold a pool thread meanwhile.
+ */
+class LottiePendingLoads {
+public:
+    using Result = std::shared_future<std::shared_ptr<LOTModel>>;
+    using Waiter = std::function<void(std::shared_ptr<LOTModel>)>;
+
+    static LottiePendingLoads &instance()
+    {
+        static LottiePendingLoads PENDING;
+        return PENDING;
+    }
+    // returns true if the caller has to parse the model and publish it
+    // with finish(). Otherwise waiter is queued if set, or result is the
+    // load to wait for.
+    bool start(const std::string &key, Result &result, Waiter waiter)
+    {
+        std::lock_guard<std::mutex> guard(mMutex);
+
+        auto search = mHash.find(key);
+        if (search != mHash.end()) {
+            if (waiter)
+                search->second.mWaiters.push_back(std::move(waiter));
+            else
+                result = search->second.mResult;
+            return false;
+        }
+        Load load;
+        result = load.mPromise.get_future().share();
+        load.mResult = result;
+        mHash.emplace(key, std::move(load));
+        return true;
+    }
+    void finish(const std::string &key, std::shared_ptr<LOTModel> model)
+    {
+        Load load;
+        {
+            std::lock_guard<std::mutex> guard(mMutex);
+            auto search = mHash.find(key);
+            if (search == mHash.end()) return;
+            load = std::move(search->second);
+            mHash.erase(search);
+        }
+        load.mPromise.set_value(model);
+        // not on this thread, it may be a synchronous load.
+        for (auto &waiter : load.mWaiters)
+            LottieTaskScheduler::instance().process(
+                [waiter = std::move(waiter), model]() { waiter(model); });
+    }
+
+private:
+    LottiePendingLoads() = default;
+
+    struct Load {
+        std::promise<std::shared_ptr<LOTModel>> mPromise;
+        Result                                  mResult;
+        std::vector<Waiter>                     mWaiters;
+    };
+
+    std::unordered_map<std::string, Load> mHash;
+    std::mutex                            mMutex;
+};
+
+#endif
+
+/*
+ * Looks up the model in the cache, or builds it with parse() and adds it
+ * to the cache. While a key is being parsed other loads of the same key
+ * share its result. A synchronous load waits for it, an asynchronous one
+ * passes done, which is called with the model from the pool once it is
+ * published, and gets false back. Otherwise model is set and true is
+ * returned.
+ */
+template <typename Parse>
+static bool sharedModel(const std::string &key, bool cachePolicy, Parse parse,
+                        std::shared_ptr<LOTModel> &model,
+                        std::function<void(std::shared_ptr<LOTModel>)> done =
+                            nullptr)
+{
+    if (!cachePolicy) {
+        model = parse();
+        return true;
+    }
+
+    model = LottieModelCache::instance().find(key);
+    if (model) return true;
+
+#ifdef LOTTIE_THREAD_SUPPORT
+    LottiePendingLoads::Result pending;
+    if (!LottiePendingLoads::instance().start(key, pending, std::move(done))) {
+        if (!pending.valid()) return false;
+        model = pending.get();
+        return true;
+    }
+
+    // the previous load may have finished between the lookup and start().
+    model = LottieModelCache::instance().find(key);
+    if (!model) model = parse();
+    if (model) LottieModelCache::instance().add(key, model);
+    LottiePendingLoads::instance().finish(key, model);
+#else
+    (void)done;
+    model = parse();
+    if (model) LottieModelCache::instance().add(key, model);
+#endif
+
+    return true;
+}
+
 void LottieLoader::configureModelCacheSize(size_t cacheSize)
 {
     LottieModelCache::instance().configureCacheSize(cacheSize);
 }
 
+void LottieLoader::releaseUnusedModels()
+{
+    LottieModelCache::instance().releaseUnused();
+}
+
+/*
+ * View of a file content. The file is memory mapped when the platform
+ * supports it so the data is paged in on demand instead of being copied
+ * into a heap buffer first. The content is always followed by a '\0'.
+ * A writable view is a private copy on write mapping, so it can be used
+ * for in-situ parsing without touching the file.
+ */
+class LottieFileView {
+public:
+    explicit LottieFileView(const std::string &path, bool writable = false)
+    {
+#ifndef _WIN32
+        int fd = open(path.c_str(), O_RDONLY);
+        if (fd < 0) return;
+
+        struct stat info;
+        if (fstat(fd, &info) == 0 && info.st_size > 0) {
+            size_t size = size_t(info.st_size);
+            int    prot = writable ? PROT_READ | PROT_WRITE : PROT_READ;
+            // reserve one more zero filled byte to terminate the content.
+            void *addr = mmap(nullptr, size + 1, prot,
+                              MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+            if (addr != MAP_FAILED) {
+                if (mmap(addr, size, prot, MAP_PRIVATE | MAP_FIXED, fd, 0) !=
+                    MAP_FAILED) {
+                    mData = static_cast<char *>(addr);
+                    mSize = size;
+                } else {
+                    munmap(addr, size + 1);
+                }
+            }
+        }
+        close(fd);
+#else
+        (void)writable;
+        std::ifstream f(path, std::ios::binary);
+        if (!f.is_open()) return;
+
+        mBuffer.assign(std::istreambuf_iterator<char>(f),
+                       std::istreambuf_iterator<char>());
+        if (mBuffer.empty()) return;
+
+        mData = &mBuffer[0];
+        mSize = mBuffer.size();
+#endif
+    }
+    ~LottieFileView()
+    {
+#ifndef _WIN32
+        if (mData) munmap(mData, mSize + 1);
+#endif
+    }
+    LottieFileView(const LottieFileView &) = delete;
+    LottieFileView &operator=(const LottieFileView &) = delete;
+
+    char * data() { return mData; }
+    size_t size() const { return mSize; }
+
+private:
+    char * mData{nullptr};
+    size_t mSize{0};
+#ifdef _WIN32
+    std::string mBuffer;
+#endif
+};
+
 static std::string dirname(const std::string &path)
 {
     const char *ptr = strrchr(path.c_str(), '/');
@@ -105,59 +322,129 @@ static std::string dirname(const std::string &path)
     return std::string(path, 0, len);
 }
 
-bool LottieLoader::load(const std::string &path, bool cachePolicy)
+static std::shared_ptr<LOTModel> parseFile(const std::string &path)
 {
-    if (cachePolicy) {
-        mModel = LottieModelCache::instance().find(path);
-        if (mModel) return true;
+    LottieFileView file(path, true);
+    if (!file.data()) {
+        vCritical << "failed to open file = " << path.c_str();
+        return nullptr;
     }
+    LottieParser parser(file.data(), dirname(path).c_str());
+    return parser.model();
+}
 
-    std::ifstream f;
-    f.open(path);
+static std::shared_ptr<LOTModel> parseData(std::string &jsonData,
+                                           const std::string &resourcePath)
+{
+    LottieParser parser(const_cast<char *>(jsonData.c_str()),
+                        resourcePath.c_str());
+    return parser.model();
+}
 
-    if (!f.is_open()) {
-        vCritical << "failed to open file = " << path.c_str();
-        return false;
-    } else {
-        std::string content;
+bool LottieLoader::load(const std::string &path, bool cachePolicy)
+{
+    sharedModel(path, cachePolicy, [&path]() { return parseFile(path); },
+                mModel);
+
+    return bool(mModel);
+}
+
+bool LottieLoader::loadFromData(std::string &&jsonData, const std::string &key,
+                                const std::string &resourcePath, bool cachePolicy)
+{
+    sharedModel(key, cachePolicy,
+                [&]() { return parseData(jsonData, resourcePath); }, mModel);
 
-        std::getline(f, content, '\0') ;
-        f.close();
+    return bool(mModel);
+}
 
-        if (content.empty()) return false;
+bool LottieLoader::loadFromData(const char *data, size_t size,
+                                const std::string &key,
+                                const std::string &resourcePath, bool cachePolicy)
+{
+    sharedModel(key, cachePolicy, [&]() {
+        LottieParser parser(data, size, resourcePath.c_str());
+        return parser.model();
+    }, mModel);
 
-        const char *str = content.c_str();
-        LottieParser parser(const_cast<char *>(str),
-                            dirname(path).c_str());
-        mModel = parser.model();
+    return bool(mModel);
+}
 
-        if (!mModel) return false;
+bool LottieLoader::loadFromBinary(const std::string &path, bool cachePolicy)
+{
+    sharedModel(path, cachePolicy, [&path]() {
+        LottieFileView file(path);
+        if (!file.data()) {
+            vCritical << "failed to open file = " << path.c_str();
+            return std::shared_ptr<LOTModel>();
+        }
+        return LottieBinary::deserialize(file.data(), file.size());
+    }, mModel);
+
+    return bool(mModel);
+}
 
-        if (cachePolicy)
-            LottieModelCache::instance().add(path, mModel);
-    }
+std::function<void(std::shared_ptr<LOTModel>)>
+LottieLoader::finisher(Done done)
+{
+    return [done = std::move(done)](std::shared_ptr<LOTModel> model) {
+        LottieLoader loader;
+        loader.mModel = std::move(model);
+        done(loader);
+    };
+}
 
-    return true;
+void LottieLoader::loadAsync(const std::string &path, bool cachePolicy,
+                             Done done)
+{
+    auto finish = finisher(std::move(done));
+    std::shared_ptr<LOTModel> model;
+    if (sharedModel(path, cachePolicy, [&path]() { return parseFile(path); },
+                    model, finish))
+        finish(std::move(model));
 }
 
-bool LottieLoader::loadFromData(std::string &&jsonData, const std::string &key,
-                                const std::string &resourcePath, bool cachePolicy)
+void LottieLoader::loadFromDataAsync(std::string &&jsonData,
+                                     const std::string &key,
+                                     const std::string &resourcePath,
+                                     bool cachePolicy, Done done)
+{
+    auto finish = finisher(std::move(done));
+    std::shared_ptr<LOTModel> model;
+    if (sharedModel(key, cachePolicy,
+                    [&]() { return parseData(jsonData, resourcePath); }, model,
+                    finish))
+        finish(std::move(model));
+}
+
+bool LottieLoader::saveToBinary(const LOTModel &model, const std::string &path)
 {
-    if (cachePolicy) {
-        mModel = LottieModelCache::instance().find(key);
-        if (mModel) return true;
+    std::string data;
+    LottieBinary::serialize(model, data);
+
+    std::ofstream f(path, std::ios::binary | std::ios::trunc);
+    if (!f.is_open()) {
+        vCritical << "failed to open file = " << path.c_str();
+        return false;
     }
+    f.write(data.data(), std::streamsize(data.size()));
 
-    LottieParser parser(const_cast<char *>(jsonData.c_str()),
-                        resourcePath.c_str());
-    mModel = parser.model();
+    return bool(f);
+}
 
-    if (!mModel) return false;
+void LottieLoader::decodeImages()
+{
+    if (!mModel) return;
 
-    if (cachePolicy)
-        LottieModelCache::instance().add(key, mModel);
+    std::vector<const LOTAsset *> images;
+    for (const auto &asset : mModel->mRoot->mAssets) {
+        if (asset.second->mAssetType == LOTAsset::Type::Image)
+            images.push_back(asset.second.get());
+    }
 
-    return true;
+    // the decoded bitmaps stay in the image cache for the first render.
+    LottieTaskScheduler::instance().parallel(
+        images.size(), [&images](size_t i) { images[i]->bitmap(); });
 }
 
 std::shared_ptr<LOTModel> LottieLoader::model()
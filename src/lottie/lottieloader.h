@@ -21,17 +21,36 @@
 
 #include<sstream>
 #include<memory>
+#include<functional>
 
 class LOTModel;
 class LottieLoader
 {
 public:
    static void configureModelCacheSize(size_t cacheSize);
+   static void releaseUnusedModels();
    bool load(const std::string &filePath, bool cachePolicy);
    bool loadFromData(std::string &&jsonData, const std::string &key,
                      const std::string &resourcePath, bool cachePolicy);
+   bool loadFromData(const char *data, size_t size, const std::string &key,
+                     const std::string &resourcePath, bool cachePolicy);
+   bool loadFromBinary(const std::string &filePath, bool cachePolicy);
+   // called with a loader holding the model, or none if the load failed.
+   using Done = std::function<void(LottieLoader &)>;
+   // like load() and loadFromData() but without waiting for a concurrent
+   // load of the same key, done is then called from the pool once that
+   // one is finished. Otherwise done is called before they return.
+   static void loadAsync(const std::string &filePath, bool cachePolicy,
+                         Done done);
+   static void loadFromDataAsync(std::string &&jsonData, const std::string &key,
+                                 const std::string &resourcePath,
+                                 bool cachePolicy, Done done);
+   static bool saveToBinary(const LOTModel &model, const std::string &filePath);
+   // decodes the image assets of the loaded model ahead of the first render.
+   void decodeImages();
    std::shared_ptr<LOTModel> model();
 private:  
+   static std::function<void(std::shared_ptr<LOTModel>)> finisher(Done done);
    std::shared_ptr<LOTModel>    mModel;
 };
 
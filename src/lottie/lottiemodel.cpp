@@ -18,8 +18,12 @@
 
 #include "lottiemodel.h"
 #include <cassert>
+#include <initializer_list>
 #include <iterator>
+#include <list>
+#include <mutex>
 #include <stack>
+#include <sys/stat.h>
 #include "vimageloader.h"
 #include "vline.h"
 
@@ -85,6 +89,376 @@ public:
     }
 };
 
+static bool isEqual(float a, float b) { return a == b; }
+
+static bool isEqual(const VPointF &a, const VPointF &b)
+{
+    return a.x() == b.x() && a.y() == b.y();
+}
+
+static bool isEqual(const LottieGradient &a, const LottieGradient &b)
+{
+    return a.mGradient == b.mGradient;
+}
+
+static bool isEqual(const LottieShapeData &a, const LottieShapeData &b)
+{
+    if (a.mClosed != b.mClosed || a.mPoints.size() != b.mPoints.size())
+        return false;
+    for (size_t i = 0; i < a.mPoints.size(); i++)
+        if (!isEqual(a.mPoints[i], b.mPoints[i])) return false;
+    return true;
+}
+
+template <typename T>
+static bool isConstant(const LOTKeyFrameValue<T> &value)
+{
+    return isEqual(value.mStartValue, value.mEndValue);
+}
+
+// a path keyframe moves along its tangents even between equal points.
+static bool isConstant(const LOTKeyFrameValue<VPointF> &value)
+{
+    return !value.mPathKeyFrame && isEqual(value.mStartValue, value.mEndValue);
+}
+
+/*
+ * Simplifies the model after parsing so that the item tree built from it
+ * is smaller and has less to update every frame. Nothing that changes the
+ * rendered output or the keypath of a fill or a stroke is touched:
+ * - hidden objects and layers are removed.
+ * - animated properties whose keyframes all hold the same value are made
+ *   static, and the static flag of their owners is updated. Fills and
+ *   strokes are left animated, a keypath value set on them later is only
+ *   applied while their layer is updated every frame.
+ * - static transforms with identity matrix and full opacity are removed.
+ * - groups without any path are removed, so are the static zero opacity
+ *   groups whose paths are not used by a paint or trim outside of them.
+ * - groups without transform that only contain paths are merged into
+ *   their parent, paths are never the target of a keypath.
+ * - root layers that are never visible in the composition frame range are
+ *   removed unless they are a parent or part of a matte.
+ * Asset layers are shared between precomp layers so each layer is visited
+ * only once.
+ */
+class LottieModelOptimizer {
+public:
+    explicit LottieModelOptimizer(LOTModelStat *s):stat(s){}
+
+    void visit(LOTCompositionData *comp)
+    {
+        cullLayers(comp);
+        visitLayer(comp->mRootLayer.get());
+        if (comp->mRootLayer->isStatic()) comp->setStatic(true);
+    }
+
+private:
+    template <typename T>
+    bool fold(LOTAnimatable<T> &obj)
+    {
+        if (obj.isStatic()) return true;
+
+        const auto &frames =
+            static_cast<const LOTAnimatable<T> &>(obj).animation().mKeyFrames;
+        if (frames.empty()) return false;
+
+        const auto &value = frames.front().mValue.mStartValue;
+        for (size_t i = 0; i < frames.size(); i++) {
+            if (!isConstant(frames[i].mValue) ||
+                !isEqual(frames[i].mValue.mStartValue, value))
+                return false;
+            // a gap between the keyframes evaluates to a default value.
+            if (i + 1 < frames.size() &&
+                frames[i].mEndFrame != frames[i + 1].mStartFrame)
+                return false;
+        }
+        obj.makeStatic(value);
+        stat->staticProperties++;
+        return true;
+    }
+
+    template <typename... Props>
+    bool foldAll(Props &... props)
+    {
+        bool result = true;
+        (void)std::initializer_list<int>{(result &= fold(props), 0)...};
+        return result;
+    }
+
+    bool foldDash(LOTDashProperty &dash)
+    {
+        bool result = true;
+        for (auto &elm : dash.mData) result &= fold(elm);
+        return result;
+    }
+
+    bool foldTransform(LOTTransformData *transform)
+    {
+        auto data = transform->data();
+        if (!data) return true;
+
+        bool result = foldAll(data->mRotation, data->mScale, data->mPosition,
+                              data->mAnchor, data->mOpacity);
+        if (data->mExtra) {
+            result &= foldAll(data->mExtra->m3DRx, data->mExtra->m3DRy,
+                              data->mExtra->m3DRz, data->mExtra->mSeparateX,
+                              data->mExtra->mSeparateY);
+        }
+        if (result) transform->makeStatic();
+        return result;
+    }
+
+    static bool identity(const LOTTransformData *transform)
+    {
+        return transform->isStatic() && transform->opacity(0) == 1.0f &&
+               transform->matrix(0).isIdentity();
+    }
+
+    // folds the properties of a content object and updates its static flag.
+    void foldContent(LOTData *obj)
+    {
+        bool result = true;
+        switch (obj->type()) {
+        case LOTData::Type::Rect: {
+            auto rect = static_cast<LOTRectData *>(obj);
+            result = foldAll(rect->mPos, rect->mSize, rect->mRound);
+            break;
+        }
+        case LOTData::Type::Ellipse: {
+            auto ellipse = static_cast<LOTEllipseData *>(obj);
+            result = foldAll(ellipse->mPos, ellipse->mSize);
+            break;
+        }
+        case LOTData::Type::Shape: {
+            result = fold(static_cast<LOTShapeData *>(obj)->mShape);
+            break;
+        }
+        case LOTData::Type::Polystar: {
+            auto star = static_cast<LOTPolystarData *>(obj);
+            result = foldAll(star->mPos, star->mPointCount, star->mInnerRadius,
+                             star->mOuterRadius, star->mInnerRoundness,
+                             star->mOuterRoundness, star->mRotation);
+            break;
+        }
+        case LOTData::Type::Fill:
+        case LOTData::Type::Stroke:
+            // the targets of the keypath values.
+            return;
+        case LOTData::Type::GFill:
+        case LOTData::Type::GStroke: {
+            auto gradient = static_cast<LOTGradient *>(obj);
+            result = foldAll(gradient->mStartPoint, gradient->mEndPoint,
+                             gradient->mHighlightLength,
+                             gradient->mHighlightAngle, gradient->mOpacity,
+                             gradient->mGradient);
+            if (obj->type() == LOTData::Type::GStroke) {
+                auto stroke = static_cast<LOTGStrokeData *>(obj);
+                result &= fold(stroke->mWidth);
+                result &= foldDash(stroke->mDash);
+            }
+            break;
+        }
+        case LOTData::Type::Trim: {
+            auto trim = static_cast<LOTTrimData *>(obj);
+            result = foldAll(trim->mStart, trim->mEnd, trim->mOffset);
+            break;
+        }
+        case LOTData::Type::Repeater: {
+            auto repeater = static_cast<LOTRepeaterData *>(obj);
+            auto &tr = repeater->mTransform;
+            result = foldAll(repeater->mCopies, repeater->mOffset, tr.mRotation,
+                             tr.mScale, tr.mPosition, tr.mAnchor,
+                             tr.mStartOpacity, tr.mEndOpacity);
+            break;
+        }
+        default:
+            return;
+        }
+        if (result) obj->setStatic(true);
+    }
+
+    static bool isPath(const LOTData *obj)
+    {
+        switch (obj->type()) {
+        case LOTData::Type::Rect:
+        case LOTData::Type::Ellipse:
+        case LOTData::Type::Shape:
+        case LOTData::Type::Polystar:
+            return true;
+        default:
+            return false;
+        }
+    }
+
+    static bool hasPath(const LOTGroupData *group)
+    {
+        for (const auto &child : group->mChildren) {
+            if (isPath(child.get())) return true;
+            if (child->type() == LOTData::Type::ShapeGroup &&
+                hasPath(static_cast<LOTGroupData *>(child.get())))
+                return true;
+            if (child->type() == LOTData::Type::Repeater) {
+                auto content = static_cast<LOTRepeaterData *>(child.get())->content();
+                if (content && hasPath(content)) return true;
+            }
+        }
+        return false;
+    }
+
+    /*
+     * pathsUsed tells if a paint or trim after the group in one of its
+     * ancestors uses the paths of the group as well.
+     */
+    void visitChildren(LOTGroupData *group, bool pathsUsed)
+    {
+        // build the list back to front as a paint or a trim affects
+        // the paths in front of it.
+        std::vector<std::shared_ptr<LOTData>> result;
+        result.reserve(group->mChildren.size());
+        for (auto it = group->mChildren.rbegin(); it != group->mChildren.rend();
+             ++it) {
+            auto child = (*it).get();
+            if (child->hidden()) {
+                stat->hiddenObjects++;
+                continue;
+            }
+            switch (child->type()) {
+            case LOTData::Type::ShapeGroup: {
+                auto childGroup = static_cast<LOTGroupData *>(child);
+                visitGroup(childGroup, pathsUsed);
+                if (!hasPath(childGroup) ||
+                    (!pathsUsed && childGroup->mTransform &&
+                     childGroup->mTransform->isStatic() &&
+                     vIsZero(childGroup->mTransform->opacity(0)))) {
+                    stat->emptyGroups++;
+                    continue;
+                }
+                if (!childGroup->mTransform &&
+                    std::all_of(childGroup->mChildren.cbegin(),
+                                childGroup->mChildren.cend(),
+                                [](const auto &obj) { return isPath(obj.get()); })) {
+                    stat->mergedGroups++;
+                    std::copy(childGroup->mChildren.rbegin(),
+                              childGroup->mChildren.rend(),
+                              std::back_inserter(result));
+                    continue;
+                }
+                break;
+            }
+            case LOTData::Type::Repeater: {
+                pathsUsed = true;
+                foldContent(child);
+                auto content = static_cast<LOTRepeaterData *>(child)->content();
+                if (content) visitGroup(content, true);
+                break;
+            }
+            case LOTData::Type::Fill:
+            case LOTData::Type::Stroke:
+            case LOTData::Type::GFill:
+            case LOTData::Type::GStroke:
+            case LOTData::Type::Trim:
+                pathsUsed = true;
+                foldContent(child);
+                break;
+            default:
+                foldContent(child);
+                break;
+            }
+            result.push_back(std::move(*it));
+        }
+        std::reverse(result.begin(), result.end());
+        group->mChildren = std::move(result);
+    }
+
+    void visitGroup(LOTGroupData *group, bool pathsUsed)
+    {
+        bool staticFlag = true;
+        if (group->mTransform) {
+            staticFlag = foldTransform(group->mTransform.get());
+            if (identity(group->mTransform.get())) {
+                stat->identityTransforms++;
+                group->mTransform = nullptr;
+            }
+        }
+
+        visitChildren(group, pathsUsed);
+
+        for (const auto &child : group->mChildren)
+            staticFlag &= child->isStatic();
+        if (staticFlag) group->setStatic(true);
+    }
+
+    void visitLayer(LOTLayerData *layer)
+    {
+        if (!mVisited.insert(layer).second) return;
+
+        bool staticFlag = true;
+        if (layer->mTransform) {
+            staticFlag = foldTransform(layer->mTransform.get());
+            if (identity(layer->mTransform.get())) {
+                stat->identityTransforms++;
+                layer->mTransform = nullptr;
+            }
+        }
+
+        if (layer->hasMask()) {
+            for (const auto &mask : layer->mExtra->mMasks) {
+                if (foldAll(mask->mShape, mask->mOpacity)) mask->mIsStatic = true;
+                staticFlag &= mask->isStatic();
+            }
+        }
+
+        if (layer->mLayerType == LayerType::Precomp) {
+            for (const auto &child : layer->mChildren)
+                visitLayer(static_cast<LOTLayerData *>(child.get()));
+        } else {
+            visitChildren(layer, false);
+        }
+
+        for (const auto &child : layer->mChildren)
+            staticFlag &= child->isStatic();
+        if (staticFlag) layer->setStatic(true);
+    }
+
+    /*
+     * the root layers are evaluated in the composition frame range, a layer
+     * is used as a matte by the layer following it.
+     */
+    void cullLayers(LOTCompositionData *comp)
+    {
+        auto &layers = comp->mRootLayer->mChildren;
+        std::vector<std::shared_ptr<LOTData>> result;
+        result.reserve(layers.size());
+        for (size_t i = 0; i < layers.size(); i++) {
+            auto layer = static_cast<LOTLayerData *>(layers[i].get());
+            bool culled = layer->hidden() ||
+                          layer->outFrame() <= comp->startFrame() ||
+                          layer->inFrame() > comp->endFrame();
+            if (culled && layer->mMatteType == MatteType::None &&
+                (i + 1 == layers.size() ||
+                 static_cast<LOTLayerData *>(layers[i + 1].get())->mMatteType ==
+                     MatteType::None) &&
+                std::none_of(layers.cbegin(), layers.cend(),
+                             [layer](const auto &obj) {
+                                 auto other = static_cast<LOTLayerData *>(obj.get());
+                                 return other->hasParent() &&
+                                        other->parentId() == layer->id();
+                             })) {
+                if (layer->hidden())
+                    stat->hiddenObjects++;
+                else
+                    stat->culledLayers++;
+                continue;
+            }
+            result.push_back(layers[i]);
+        }
+        layers = std::move(result);
+    }
+
+    LOTModelStat                      *stat;
+    std::unordered_set<LOTLayerData *> mVisited;
+};
+
 class LottieUpdateStatVisitor {
     LOTModelStat *stat;
 public:
@@ -146,6 +520,12 @@ void LOTCompositionData::processRepeaterObjects()
     visitor.visit(mRootLayer.get());
 }
 
+void LOTCompositionData::optimize()
+{
+    LottieModelOptimizer visitor(&mStats);
+    visitor.visit(this);
+}
+
 void LOTCompositionData::updateStats()
 {
     LottieUpdateStatVisitor visitor(&mStats);
@@ -357,13 +737,279 @@ void LOTGradient::update(std::unique_ptr<VGradient> &grad, int frameNo)
     }
 }
 
+/*
+ * Process wide cache of the decoded image assets. The bitmaps are keyed
+ * by the hash of the encoded data (embedded images) or by the resolved
+ * file path, modification time and size (see loadImagePath()) so that the
+ * same image used by different models is decoded once and shared by
+ * reference. As different images can hash the same,
+ * an entry keeps the encoded data it was decoded from and a hit has to
+ * match it. The encoded data an entry keeps is counted with its bitmap,
+ * least recently used entries are released when their total size exceeds
+ * the configured budget, the assets keep their encoded data so they can
+ * be decoded again on next use.
+ */
+class LOTAssetImageCache {
+public:
+    static LOTAssetImageCache &instance()
+    {
+        static LOTAssetImageCache CACHE;
+        return CACHE;
+    }
+
+    VBitmap bitmap(const LOTAsset *asset)
+    {
+        const std::string &key = asset->mImageKey;
+        if (key.empty()) return VBitmap();
+
+        {
+            std::lock_guard<std::mutex> guard(mMutex);
+            auto search = find(asset);
+            if (search != mLru.end()) {
+                mStats.hits++;
+                mLru.splice(mLru.begin(), mLru, search);
+                return search->mBitmap;
+            }
+            mStats.misses++;
+        }
+
+        // decode outside the lock so that other images are not blocked.
+        VBitmap bitmap;
+        if (asset->mImageData) {
+            bitmap = VImageLoader::instance().load(asset->mImageData->c_str(),
+                                                   asset->mImageData->length());
+        } else if (!asset->mImagePath.empty()) {
+            bitmap = VImageLoader::instance().load(asset->mImagePath.c_str());
+        }
+        if (!bitmap.valid()) return bitmap;
+
+        std::lock_guard<std::mutex> guard(mMutex);
+        // some other thread already decoded it.
+        auto search = find(asset);
+        if (search != mLru.end()) {
+            mLru.splice(mLru.begin(), mLru, search);
+            return search->mBitmap;
+        }
+
+        mLru.push_front({key, asset->mImageData, bitmap});
+        mHash.emplace(key, mLru.begin());
+        mStats.size += byteSize(mLru.front());
+        mStats.dataSize += dataSize(mLru.front());
+        mStats.count++;
+        evict(1);
+        return bitmap;
+    }
+
+    void configureCacheSize(size_t cacheSize)
+    {
+        std::lock_guard<std::mutex> guard(mMutex);
+        mCacheSize = cacheSize;
+        evict(0);
+    }
+
+    size_t release()
+    {
+        std::lock_guard<std::mutex> guard(mMutex);
+        size_t bytes = mStats.size;
+        mStats.evictions += mLru.size();
+        mStats.size = 0;
+        mStats.dataSize = 0;
+        mStats.count = 0;
+        mHash.clear();
+        mLru.clear();
+        return bytes;
+    }
+
+    LOTImageCacheStats stats()
+    {
+        std::lock_guard<std::mutex> guard(mMutex);
+        return mStats;
+    }
+
+private:
+    LOTAssetImageCache() = default;
+
+    struct Entry {
+        std::string                        mKey;
+        std::shared_ptr<const std::string> mData;  // null for image files
+        VBitmap                            mBitmap;
+    };
+
+    std::list<Entry>::iterator find(const LOTAsset *asset)
+    {
+        auto range = mHash.equal_range(asset->mImageKey);
+        for (auto it = range.first; it != range.second; ++it) {
+            const auto &data = it->second->mData;
+            if (data == asset->mImageData ||
+                (data && asset->mImageData && *data == *asset->mImageData))
+                return it->second;
+        }
+        return mLru.end();
+    }
+
+    static size_t dataSize(const Entry &entry)
+    {
+        return entry.mData ? entry.mData->size() : 0;
+    }
+
+    static size_t byteSize(const Entry &entry)
+    {
+        return entry.mBitmap.stride() * entry.mBitmap.height() +
+               dataSize(entry);
+    }
+
+    // keep the most recently used ones even if they alone
+    // exceed the budget.
+    void evict(size_t keep)
+    {
+        while (mStats.size > mCacheSize && mLru.size() > keep) {
+            Entry &victim = mLru.back();
+            mStats.size -= byteSize(victim);
+            mStats.dataSize -= dataSize(victim);
+            mStats.count--;
+            mStats.evictions++;
+            auto range = mHash.equal_range(victim.mKey);
+            for (auto it = range.first; it != range.second; ++it) {
+                if (&*it->second == &victim) {
+                    mHash.erase(it);
+                    break;
+                }
+            }
+            mLru.pop_back();
+        }
+    }
+
+    std::list<Entry>                                              mLru;
+    std::unordered_multimap<std::string, std::list<Entry>::iterator> mHash;
+    std::mutex                                                    mMutex;
+    LOTImageCacheStats                                            mStats;
+    size_t mCacheSize{64 * 1024 * 1024};
+};
+
+VBitmap LOTAsset::bitmap() const
+{
+    if (mAssetType != Type::Image) return VBitmap();
+
+    return LOTAssetImageCache::instance().bitmap(this);
+}
+
 void LOTAsset::loadImageData(std::string data)
 {
-    if (!data.empty())
-        mBitmap = VImageLoader::instance().load(data.c_str(), data.length());
+    if (data.empty()) return;
+
+    // content address of the embedded image.
+    mImageKey = "data:" + std::to_string(std::hash<std::string>()(data)) +
+                ":" + std::to_string(data.length());
+    mImageData = std::make_shared<const std::string>(std::move(data));
 }
 
+/*
+ * The file is identified by its modification time and size when the model
+ * is loaded, so a model loaded after the file changed doesn't get the
+ * bitmap of the old content. The entries are not revalidated afterwards:
+ * the bitmap cached for a key is used until it is evicted, and decoding it
+ * again reads the file as it is at that time.
+ */
 void LOTAsset::loadImagePath(std::string path)
 {
-    if (!path.empty()) mBitmap = VImageLoader::instance().load(path.c_str());
+    if (path.empty()) return;
+
+    mImageKey = "path:" + path;
+    struct stat info;
+    if (stat(path.c_str(), &info) == 0) {
+        mImageKey += ":" + std::to_string(info.st_mtime) + ":" +
+                     std::to_string(info.st_size);
+    }
+    mImagePath = std::move(path);
+}
+
+void LOTAsset::configureImageCacheSize(size_t cacheSize)
+{
+    LOTAssetImageCache::instance().configureCacheSize(cacheSize);
+}
+
+size_t LOTAsset::releaseImageCache()
+{
+    return LOTAssetImageCache::instance().release();
+}
+
+LOTImageCacheStats LOTAsset::imageCacheStats()
+{
+    return LOTAssetImageCache::instance().stats();
+}
+
+class LOTInterpolatorTable {
+public:
+    static LOTInterpolatorTable &instance()
+    {
+        static LOTInterpolatorTable TABLE;
+        return TABLE;
+    }
+
+    std::shared_ptr<VInterpolator> intern(VPointF p1, VPointF p2,
+                                          int bakedFrames)
+    {
+        // +0.0f folds -0.0f into 0.0f so equal points hash the same.
+        Key key{{p1.x() + 0.0f, p1.y() + 0.0f, p2.x() + 0.0f, p2.y() + 0.0f},
+                bakedFrames};
+
+        std::lock_guard<std::mutex> guard(mMutex);
+        auto &entry = mHash[key];
+        if (auto curve = entry.lock()) return curve;
+
+        auto curve = std::make_shared<VInterpolator>(p1, p2);
+        if (bakedFrames) curve->bake(bakedFrames);
+        entry = curve;
+
+        // drop the curves of the released models once in a while.
+        if (mHash.size() > mSweepSize) {
+            for (auto it = mHash.begin(); it != mHash.end();) {
+                if (it->second.expired())
+                    it = mHash.erase(it);
+                else
+                    ++it;
+            }
+            mSweepSize = std::max(minSweepSize, 2 * mHash.size());
+        }
+        return curve;
+    }
+
+private:
+    LOTInterpolatorTable() = default;
+
+    struct Key {
+        float mPoints[4];
+        int   mBakedFrames;
+        bool  operator==(const Key &o) const
+        {
+            return mBakedFrames == o.mBakedFrames &&
+                   mPoints[0] == o.mPoints[0] && mPoints[1] == o.mPoints[1] &&
+                   mPoints[2] == o.mPoints[2] && mPoints[3] == o.mPoints[3];
+        }
+    };
+    struct KeyHash {
+        size_t operator()(const Key &key) const
+        {
+            size_t seed = std::hash<int>()(key.mBakedFrames);
+            for (float v : key.mPoints)
+                seed ^= std::hash<float>()(v) + 0x9e3779b9 + (seed << 6) +
+                        (seed >> 2);
+            return seed;
+        }
+    };
+
+    static constexpr size_t minSweepSize = 256;
+
+    std::unordered_map<Key, std::weak_ptr<VInterpolator>, KeyHash> mHash;
+    std::mutex                                                      mMutex;
+    size_t mSweepSize{minSweepSize};
+};
+
+constexpr size_t LOTInterpolatorTable::minSweepSize;
+
+std::shared_ptr<VInterpolator> LOTInterpolatorPool::intern(VPointF p1,
+                                                           VPointF p2,
+                                                           int bakedFrames)
+{
+    return LOTInterpolatorTable::instance().intern(p1, p2, bakedFrames);
 }
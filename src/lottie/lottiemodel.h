@@ -22,7 +22,10 @@
 #include<vector>
 #include<memory>
 #include<unordered_map>
+#include<unordered_set>
+#include<mutex>
 #include<algorithm>
+#include<atomic>
 #include <cmath>
 #include <cstring>
 #include"vpoint.h"
@@ -55,12 +58,19 @@ class LOTMaskData;
 
 struct LOTModelStat
 {
-    uint16_t precompLayerCount{0};
-    uint16_t solidLayerCount{0};
-    uint16_t shapeLayerCount{0};
-    uint16_t imageLayerCount{0};
-    uint16_t nullLayerCount{0};
-
+    uint32_t precompLayerCount{0};
+    uint32_t solidLayerCount{0};
+    uint32_t shapeLayerCount{0};
+    uint32_t imageLayerCount{0};
+    uint32_t nullLayerCount{0};
+
+    // objects removed or folded by LOTCompositionData::optimize()
+    uint32_t hiddenObjects{0};
+    uint32_t emptyGroups{0};      // zero opacity groups and groups without path
+    uint32_t mergedGroups{0};
+    uint32_t identityTransforms{0};
+    uint32_t culledLayers{0};     // never visible in the composition range
+    uint32_t staticProperties{0}; // animated properties holding one value
 };
 
 enum class MatteType: uchar
@@ -178,6 +188,7 @@ struct LOTKeyFrameValue
         return lerp(mStartValue, mEndValue, t);
     }
     float angle(float ) const { return 0;}
+    void cacheArcLengths() {}
 };
 
 template <>
@@ -195,9 +206,8 @@ struct LOTKeyFrameValue<VPointF>
              * position along the path calcualated
              * using bezier at progress length (t * bezlen)
              */
-            VBezier b = VBezier::fromPoints(mStartValue, mStartValue + mOutTangent,
-                                       mEndValue + mInTangent, mEndValue);
-            return b.pointAt(b.tAtLength(t * b.length()));
+            VBezier b = bezier();
+            return b.pointAt(tAtProgress(b, t));
 
         }
         return lerp(mStartValue, mEndValue, t);
@@ -205,12 +215,68 @@ struct LOTKeyFrameValue<VPointF>
 
     float angle(float t) const {
         if (mPathKeyFrame) {
-            VBezier b = VBezier::fromPoints(mStartValue, mStartValue + mOutTangent,
-                                       mEndValue + mInTangent, mEndValue);
-            return b.angleAt(b.tAtLength(t * b.length()));
+            VBezier b = bezier();
+            return b.angleAt(tAtProgress(b, t));
         }
         return 0;
     }
+
+    /*
+     * Samples the length of the path up to uniform steps of the curve
+     * parameter so that value() and angle() map the progress with a
+     * lookup instead of searching the parameter with tAtLength() at every
+     * call. The samples use the same VBezier::length() measure, a looked
+     * up position stays within 0.05 of the one tAtLength() gives. To be
+     * called once the start and end values are final.
+     */
+    void cacheArcLengths() {
+        mArcLengths.clear();
+        if (!mPathKeyFrame) return;
+
+        VBezier b = bezier();
+        float length = b.length();
+        // about one sample per unit of length, the length is far from
+        // linear in the curve parameter near a cusp so short paths get more.
+        const int minArcSteps = 64;
+        const int maxArcSteps = 1024;
+        int steps = int(std::ceil(length));
+        steps = std::max(minArcSteps, std::min(steps, maxArcSteps));
+
+        mArcLengths.reserve(size_t(steps) + 1);
+        mArcLengths.push_back(0);
+        for (int i = 1; i < steps; i++) {
+            VBezier right = b, left;
+            right.parameterSplitLeft(float(i) / float(steps), &left);
+            // the measure is not exactly monotonic, the table has to be.
+            mArcLengths.push_back(std::max(mArcLengths.back(), left.length()));
+        }
+        mArcLengths.push_back(std::max(mArcLengths.back(), length));
+    }
+
+private:
+    VBezier bezier() const {
+        return VBezier::fromPoints(mStartValue, mStartValue + mOutTangent,
+                                   mEndValue + mInTangent, mEndValue);
+    }
+
+    // curve parameter at progress t of the path length.
+    float tAtProgress(const VBezier &b, float t) const {
+        if (mArcLengths.empty()) return b.tAtLength(t * b.length());
+
+        float total = mArcLengths.back();
+        float len = t * total;
+        if (len > total || vCompare(len, total)) return 1;
+        if (len <= 0) return 0;
+
+        auto it = std::upper_bound(mArcLengths.cbegin(), mArcLengths.cend(), len);
+        size_t index = size_t(it - mArcLengths.cbegin()) - 1;
+        float  segment = mArcLengths[index + 1] - mArcLengths[index];
+        float  frac = segment > 0 ? (len - mArcLengths[index]) / segment : 0;
+        return (float(index) + frac) / float(mArcLengths.size() - 1);
+    }
+
+public:
+    std::vector<float> mArcLengths; // length up to uniform steps of t
 };
 
 
@@ -219,7 +285,11 @@ class LOTKeyFrame
 {
 public:
     float progress(int frameNo) const {
-        return mInterpolator ? mInterpolator->value((frameNo - mStartFrame) / (mEndFrame - mStartFrame)) : 0;
+        if (!mInterpolator) return 0;
+        int step = frameNo - int(mStartFrame);
+        if (step >= 0 && step < mInterpolator->bakedFrames())
+            return mInterpolator->bakedValue(step);
+        return mInterpolator->value((frameNo - mStartFrame) / (mEndFrame - mStartFrame));
     }
     T value(int frameNo) const {
         return mValue.value(progress(frameNo));
@@ -235,6 +305,39 @@ public:
     LOTKeyFrameValue<T>  mValue;
 };
 
+/*
+ * Process wide table of the easing curves keyed by their control points,
+ * so that the models share the handful of curves most of the resources
+ * use instead of allocating their own copies. The curves are held weakly
+ * and go away with the last model using them.
+ */
+class LOTInterpolatorPool
+{
+public:
+    static std::shared_ptr<VInterpolator> intern(VPointF p1, VPointF p2,
+                                                 int bakedFrames = 0);
+
+    /*
+     * Replaces the interpolator of the keyframes spanning a whole number
+     * of frames by a copy baked for that span (see VInterpolator::bake()).
+     * The copies are shared by the keyframes having the same curve and span.
+     */
+    template<typename T>
+    static void bake(LOTKeyFrame<T> &keyFrame)
+    {
+        const auto &curve = keyFrame.mInterpolator;
+        float start = keyFrame.mStartFrame;
+        float span = keyFrame.mEndFrame - start;
+        if (!curve || curve->bakedFrames() || span < 1 || span > maxFrames ||
+            start != std::floor(start) || span != std::floor(span))
+            return;
+
+        keyFrame.mInterpolator = intern(curve->p1(), curve->p2(), int(span));
+    }
+private:
+    static constexpr int maxFrames = 1024;
+};
+
 template<typename T>
 class LOTAnimInfo
 {
@@ -245,11 +348,8 @@ public:
         if(mKeyFrames.back().mEndFrame <= frameNo)
             return mKeyFrames.back().mValue.mEndValue;
 
-        for(const auto &keyFrame : mKeyFrames) {
-            if (frameNo >= keyFrame.mStartFrame && frameNo < keyFrame.mEndFrame)
-                return keyFrame.value(frameNo);
-        }
-        return T();
+        int index = keyFrameIndex(frameNo);
+        return index < 0 ? T() : mKeyFrames[size_t(index)].value(frameNo);
     }
 
     float angle(int frameNo) const {
@@ -257,11 +357,8 @@ public:
             (mKeyFrames.back().mEndFrame <= frameNo) )
             return 0;
 
-        for(const auto &keyFrame : mKeyFrames) {
-            if (frameNo >= keyFrame.mStartFrame && frameNo < keyFrame.mEndFrame)
-                return keyFrame.angle(frameNo);
-        }
-        return 0;
+        int index = keyFrameIndex(frameNo);
+        return index < 0 ? 0 : mKeyFrames[size_t(index)].angle(frameNo);
     }
 
     bool changed(int prevFrame, int curFrame) const {
@@ -272,8 +369,49 @@ public:
                  (last < prevFrame  && last < curFrame));
     }
 
+    /*
+     * index of the keyframe containing frameNo or -1.
+     * The last found keyframe is remembered so the sequential and the
+     * ping-pong playback find it (or its neighbour) without a search,
+     * otherwise the sorted keyframes are binary searched. The model is
+     * shared by the players so the cursor is only a hint.
+     */
+    int keyFrameIndex(int frameNo) const {
+        int count = int(mKeyFrames.size());
+        int cursor = mCursor.load(std::memory_order_relaxed);
+
+        for (int i : {cursor, cursor + 1, cursor - 1}) {
+            if (i >= 0 && i < count && contains(i, frameNo)) return found(i);
+        }
+
+        auto it = std::upper_bound(mKeyFrames.cbegin(), mKeyFrames.cend(),
+                                   frameNo, [](int frame, const auto &keyFrame) {
+                                       return frame < keyFrame.mStartFrame;
+                                   });
+        int index = int(it - mKeyFrames.cbegin()) - 1;
+        if (index >= 0 && contains(index, frameNo)) return found(index);
+
+        // keyframes out of order.
+        for (int i = 0; i < count; i++) {
+            if (contains(i, frameNo)) return found(i);
+        }
+        return -1;
+    }
+
+private:
+    bool contains(int index, int frameNo) const {
+        const auto &keyFrame = mKeyFrames[size_t(index)];
+        return frameNo >= keyFrame.mStartFrame && frameNo < keyFrame.mEndFrame;
+    }
+    int found(int index) const {
+        mCursor.store(index, std::memory_order_relaxed);
+        return index;
+    }
+
 public:
     std::vector<LOTKeyFrame<T>>    mKeyFrames;
+private:
+    mutable std::atomic<int>       mCursor{0};
 };
 
 template<typename T>
@@ -302,6 +440,14 @@ public:
         return impl.mValue;
     }
 
+    // replaces the animation by a single value.
+    void makeStatic(T val)
+    {
+        destroy();
+        construct(impl.mValue, std::move(val));
+        mStatic = true;
+    }
+
     LOTAnimatable(LOTAnimatable &&other) noexcept {
         if (!other.mStatic) {
             construct(impl.mAnimInfo, std::move(other.impl.mAnimInfo));
@@ -373,13 +519,13 @@ public:
             if(vec.back().mEndFrame <= frameNo)
                 return vec.back().mValue.mEndValue.toPath(path);
 
-            for(const auto &keyFrame : vec) {
-                if (frameNo >= keyFrame.mStartFrame && frameNo < keyFrame.mEndFrame) {
-                    LottieShapeData::lerp(keyFrame.mValue.mStartValue,
-                                          keyFrame.mValue.mEndValue,
-                                          keyFrame.progress(frameNo),
-                                          path);
-                }
+            int index = animation().keyFrameIndex(frameNo);
+            if (index >= 0) {
+                const auto &keyFrame = vec[size_t(index)];
+                LottieShapeData::lerp(keyFrame.mValue.mStartValue,
+                                      keyFrame.mValue.mEndValue,
+                                      keyFrame.progress(frameNo),
+                                      path);
             }
         }
     }
@@ -394,6 +540,37 @@ enum class LottieBlendMode: uchar
     OverLay = 3
 };
 
+/*
+ * Per model pool of the strings referenced by the model objects.
+ * Each distinct string is stored once and the returned pointer stays
+ * valid for the life time of the pool, so interned strings can be
+ * compared by pointer. The pool is filled concurrently when the assets
+ * are parsed in parallel, it is locked only while it is shared that way.
+ */
+class LOTStringPool
+{
+public:
+    const char *intern(const char *str)
+    {
+        if (!str) return nullptr;
+        if (!mShared) return mPool.emplace(str).first->c_str();
+        std::lock_guard<std::mutex> guard(mMutex);
+        return mPool.emplace(str).first->c_str();
+    }
+    const char *intern(const std::string &str)
+    {
+        if (!mShared) return mPool.insert(str).first->c_str();
+        std::lock_guard<std::mutex> guard(mMutex);
+        return mPool.insert(str).first->c_str();
+    }
+    // must be changed only when no other thread uses the pool.
+    void setShared(bool shared) { mShared = shared; }
+private:
+    std::unordered_set<std::string> mPool;
+    std::mutex                      mMutex;
+    bool                            mShared{false};
+};
+
 class LOTDataVisitor;
 class LOTData
 {
@@ -422,7 +599,6 @@ public:
        mData._shortString = true;
        mData._hidden = false;
     }
-    ~LOTData() { if (!shortString() && mPtr) free(mPtr); }
     LOTData(const LOTData&) = delete;
     LOTData& operator =(const LOTData&) = delete;
 
@@ -432,7 +608,11 @@ public:
     void setHidden(bool value) {mData._hidden = value;}
     void setType(LOTData::Type type) {mData._type = type;}
     LOTData::Type type() const { return mData._type;}
-    void setName(const char *name)
+    /*
+     * short names are stored inline, longer ones are interned in the
+     * string pool of the model that owns the object.
+     */
+    void setName(const char *name, LOTStringPool &pool)
     {
         if (name) {
             auto len = strlen(name);
@@ -441,7 +621,7 @@ public:
                 strncpy ( mData._buffer, name, len+1);
             } else {
                 setShortString(false);
-                mPtr = strdup(name);
+                mPtr = pool.intern(name);
             }
 
         }
@@ -459,8 +639,8 @@ private:
       bool           _shortString : 1;
     };
     union {
-        Data  mData;
-        char *mPtr;
+        Data        mData;
+        const char *mPtr;
     };
 };
 
@@ -480,6 +660,16 @@ public:
 };
 
 class LOTLayerData;
+struct LOTImageCacheStats
+{
+    size_t hits{0};
+    size_t misses{0};
+    size_t evictions{0};
+    size_t count{0};     // number of decoded images in the cache
+    size_t size{0};      // total bytes of the cache entries
+    size_t dataSize{0};  // bytes of encoded data kept by the entries
+};
+
 struct LOTAsset
 {
     enum class Type : unsigned char{
@@ -489,17 +679,26 @@ struct LOTAsset
     };
     bool isStatic() const {return mStatic;}
     void setStatic(bool value) {mStatic = value;}
-    VBitmap  bitmap() const {return mBitmap;}
+    /*
+     * image is decoded on first use through the process wide image
+     * cache and shared with other assets having the same content.
+     */
+    VBitmap  bitmap() const;
     void loadImageData(std::string data);
     void loadImagePath(std::string Path);
+    static void configureImageCacheSize(size_t cacheSize);
+    static size_t releaseImageCache();
+    static LOTImageCacheStats imageCacheStats();
     Type                                      mAssetType{Type::Precomp};
     bool                                      mStatic{true};
-    std::string                               mRefId; // ref id
+    const char                               *mRefId{nullptr}; // interned ref id
     std::vector<std::shared_ptr<LOTData>>     mLayers;
     // image asset data
     int                                       mWidth{0};
     int                                       mHeight{0};
-    VBitmap                                   mBitmap;
+    std::shared_ptr<const std::string>        mImageData; // encoded image
+    std::string                               mImagePath;
+    std::string                               mImageKey;  // image cache key
 };
 
 struct TransformDataExtra
@@ -542,6 +741,27 @@ public:
             new (&impl.mData) std::unique_ptr<TransformData>(std::move(data));
         }
     }
+    void set(VMatrix matrix, float opacity)
+    {
+        setStatic(true);
+        new (&impl.mStaticData) static_data(std::move(matrix), opacity);
+    }
+    const TransformData *data() const
+    {
+        return isStatic() ? nullptr : impl.mData.get();
+    }
+    TransformData *data()
+    {
+        return isStatic() ? nullptr : impl.mData.get();
+    }
+    // to be called once all the properties of the data are static.
+    void makeStatic()
+    {
+        if (isStatic()) return;
+        auto data = std::move(impl.mData);
+        destroy();
+        set(std::move(data), true);
+    }
     VMatrix matrix(int frameNo, bool autoOrient = false) const
     {
         if (isStatic()) return impl.mStaticData.mMatrix;
@@ -588,7 +808,7 @@ private:
 struct ExtraLayerData
 {
     LottieColor                mSolidColor;
-    std::string                mPreCompRefId;
+    const char                *mPreCompRefId{nullptr}; // interned ref id
     LOTAnimatable<float>       mTimeRemap;  /* "tm" */
     LOTCompositionData        *mCompRef{nullptr};
     std::shared_ptr<LOTAsset>  mAsset;
@@ -677,16 +897,19 @@ public:
     long endFrame() const {return mEndFrame;}
     VSize size() const {return mSize;}
     void processRepeaterObjects();
+    void optimize();
     void updateStats();
 public:
-    std::string          mVersion;
+    LOTStringPool        mStringPool;
+    const char          *mVersion{nullptr}; // interned
     VSize                mSize;
     long                 mStartFrame{0};
     long                 mEndFrame{0};
     float                mFrameRate{60};
     LottieBlendMode      mBlendMode{LottieBlendMode::Normal};
     std::shared_ptr<LOTLayerData> mRootLayer;
-    std::unordered_map<std::string,
+    // keyed by the interned ref id
+    std::unordered_map<const char *,
                        std::shared_ptr<LOTAsset>>    mAssets;
 
     std::vector<LayerInfo>  mLayerInfoList;
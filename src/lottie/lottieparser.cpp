@@ -48,13 +48,40 @@
 // the array immediately. If you fetch the entire array (i.e. NextArrayValue()
 // returned null), you should not call SkipArray().
 //
-// This parser uses in-situ strings, so the JSON buffer will be altered during
-// the parse.
+// When constructed from a mutable buffer the parser uses in-situ strings, so
+// the JSON buffer will be altered during the parse. When constructed from a
+// read only buffer the JSON data is left untouched and only the strings are
+// copied to a memory pool owned by the parser.
 
 #include <array>
 
+#include "config.h"
 #include "lottiemodel.h"
+#include "lottietaskscheduler.h"
+
+// let rapidjson skip the whitespace and scan the strings 16 bytes at a time.
+#if defined(__SSE4_2__)
+#define RAPIDJSON_SSE42
+#elif defined(__SSE2__)
+#define RAPIDJSON_SSE2
+#elif defined(__ARM_NEON)
+#define RAPIDJSON_NEON
+#endif
+
 #include "rapidjson/document.h"
+#include "rapidjson/memorystream.h"
+
+#ifdef RAPIDJSON_SIMD
+RAPIDJSON_NAMESPACE_BEGIN
+// the read only parsing reads from a MemoryStream which rapidjson
+// doesn't specialize.
+template <>
+inline void SkipWhitespace(MemoryStream &is)
+{
+    is.src_ = SkipWhitespace_SIMD(is.src_, is.end_);
+}
+RAPIDJSON_NAMESPACE_END
+#endif
 
 RAPIDJSON_DIAG_PUSH
 #ifdef __GNUC__
@@ -108,10 +135,10 @@ public:
         return true;
     }
     bool RawNumber(const char *, SizeType, bool) { return false; }
-    bool String(const char *str, SizeType length, bool)
+    bool String(const char *str, SizeType length, bool copy)
     {
         st_ = kHasString;
-        v_.SetString(str, length);
+        setString(str, length, copy);
         return true;
     }
     bool StartObject()
@@ -119,10 +146,10 @@ public:
         st_ = kEnteringObject;
         return true;
     }
-    bool Key(const char *str, SizeType length, bool)
+    bool Key(const char *str, SizeType length, bool copy)
     {
         st_ = kHasKey;
-        v_.SetString(str, length);
+        setString(str, length, copy);
         return true;
     }
     bool EndObject(SizeType)
@@ -143,6 +170,36 @@ public:
 
 protected:
     explicit LookaheadParserHandler(char *str);
+    LookaheadParserHandler(const char *data, size_t size);
+
+    /*
+     * the reader reuses its buffer for the non in-situ strings,
+     * so keep a copy that stays valid until the parsing is done.
+     * (not a copy inside v_ as short strings are stored inline and
+     * get overwritten by the next token)
+     */
+    // current read position and the end of the json data (null when the
+    // data is terminated by '\0').
+    const char *position() const { return insitu_ ? ss_.src_ : ms_.src_; }
+    const char *dataEnd() const { return insitu_ ? nullptr : ms_.end_; }
+    void        seek(const char *pos)
+    {
+        if (insitu_)
+            ss_.src_ = const_cast<char *>(pos);
+        else
+            ms_.src_ = pos;
+    }
+
+    void setString(const char *str, SizeType length, bool copy)
+    {
+        if (copy) {
+            auto buffer = static_cast<char *>(allocator_.Malloc(length + 1));
+            memcpy(buffer, str, length);
+            buffer[length] = '\0';
+            str = buffer;
+        }
+        v_.SetString(str, length);
+    }
 
 protected:
     enum LookaheadParsingState {
@@ -163,16 +220,27 @@ protected:
     LookaheadParsingState st_;
     Reader                r_;
     InsituStringStream    ss_;
-
-    static const int parseFlags = kParseDefaultFlags | kParseInsituFlag;
+    MemoryStream          ms_;
+    MemoryPoolAllocator<> allocator_;
+    bool                  insitu_;
+
+    // the parsing stops at the end of the root value, this lets an asset be
+    // parsed from its byte range inside the whole document.
+    static const int parseFlags =
+        kParseDefaultFlags | kParseInsituFlag | kParseStopWhenDoneFlag;
+    static const int readOnlyParseFlags =
+        kParseDefaultFlags | kParseStopWhenDoneFlag;
 };
 
 class LottieParserImpl : public LookaheadParserHandler {
 public:
     LottieParserImpl(char *str, const char *dir_path)
         : LookaheadParserHandler(str), mDirPath(dir_path) {}
+    LottieParserImpl(const char *data, size_t size, const char *dir_path)
+        : LookaheadParserHandler(data, size), mDirPath(dir_path) {}
     bool VerifyType();
     bool ParseNext();
+    void skipToClose(const char *close);
 public:
     bool        EnterObject();
     bool        EnterArray();
@@ -187,6 +255,7 @@ public:
     void   SkipObject();
     void   SkipArray();
     void   SkipValue();
+    bool   GetNumberArray();
     Value *PeekValue();
     int PeekType() const;
     bool IsValid() { return st_ != kError; }
@@ -208,6 +277,7 @@ public:
     void                         parseMarkers();
     void                         parseMarker();
     void                         parseAssets(LOTCompositionData *comp);
+    bool                         parseAssetsParallel(LOTCompositionData *comp);
     std::shared_ptr<LOTAsset>    parseAsset();
     void                         parseLayers(LOTCompositionData *comp);
     std::shared_ptr<LOTData>     parseLayer(bool record = false);
@@ -259,6 +329,10 @@ public:
     std::shared_ptr<VInterpolator> interpolator(VPointF, VPointF, std::string);
 
     LottieColor toColor(const char *str);
+    const char *GetInternedString()
+    {
+        return compRef->mStringPool.intern(GetString());
+    }
 
     void resolveLayerRefs();
 
@@ -274,11 +348,18 @@ protected:
     std::vector<VPointF>                       mInPoint;  /* "i" */
     std::vector<VPointF>                       mOutPoint; /* "o" */
     std::vector<VPointF>                       mVertices;
+    std::vector<double>                        mNumbers; /* GetNumberArray() */
     void                                       SkipOut(int depth);
 };
 
 LookaheadParserHandler::LookaheadParserHandler(char *str)
-    : v_(), st_(kInit), ss_(str)
+    : v_(), st_(kInit), ss_(str), ms_(nullptr, 0), insitu_(true)
+{
+    r_.IterativeParseInit();
+}
+
+LookaheadParserHandler::LookaheadParserHandler(const char *data, size_t size)
+    : v_(), st_(kInit), ss_(nullptr), ms_(data, size), insitu_(false)
 {
     r_.IterativeParseInit();
 }
@@ -297,7 +378,12 @@ bool LottieParserImpl::ParseNext()
         return false;
     }
 
-    if (!r_.IterativeParseNext<parseFlags>(ss_, *this)) {
+    // nothing left once the root value is complete.
+    if (r_.IterativeParseComplete()) return true;
+
+    bool result = insitu_ ? r_.IterativeParseNext<parseFlags>(ss_, *this)
+                          : r_.IterativeParseNext<readOnlyParseFlags>(ms_, *this);
+    if (!result) {
         vCritical << "Lottie file parsing error";
         st_ = kError;
         return false;
@@ -305,6 +391,20 @@ bool LottieParserImpl::ParseNext()
     return true;
 }
 
+/*
+ * Resumes the reader after an array or object whose content was scanned
+ * without it. close points to the closing bracket of the value the reader
+ * has entered: the first ParseNext() takes the bracket and the second one
+ * moves to the next value, which leaves the reader in the same state as
+ * SkipArray() or SkipObject() would.
+ */
+void LottieParserImpl::skipToClose(const char *close)
+{
+    seek(close);
+    ParseNext();
+    ParseNext();
+}
+
 bool LottieParserImpl::EnterObject()
 {
     if (st_ != kEnteringObject) {
@@ -504,8 +604,137 @@ int LottieParserImpl::PeekType() const
     return -1;
 }
 
+/*
+ * Raw scanning helpers working on the json text itself, used to skip or
+ * read the simple parts of the document without going through the token
+ * dispatch. The data ends at end, or at a '\0' when end is null.
+ */
+static inline bool isValid(const char *p, const char *end)
+{
+    return p != end && *p;
+}
+
+static const char *skipSpace(const char *p, const char *end)
+{
+    while (isValid(p, end) &&
+           (*p == ' ' || *p == '\n' || *p == '\r' || *p == '\t'))
+        p++;
+    return p;
+}
+
+static inline bool isDigit(const char *p, const char *end)
+{
+    return isValid(p, end) && *p >= '0' && *p <= '9';
+}
+
+/*
+ * Returns the position of the bracket closing the given number of open
+ * objects/arrays, or null when the data ends before. Strings are skipped
+ * without decoding them so the data is left untouched.
+ */
+static const char *scanClose(const char *p, const char *end, int depth)
+{
+    for (; isValid(p, end); p++) {
+        if (*p == '"') {
+            for (p++; isValid(p, end) && *p != '"'; p++) {
+                if (*p == '\\' && !isValid(++p, end)) return nullptr;
+            }
+            if (!isValid(p, end)) return nullptr;
+        } else if (*p == '{' || *p == '[') {
+            depth++;
+        } else if (*p == '}' || *p == ']') {
+            if (--depth == 0) return p;
+        }
+    }
+    return nullptr;
+}
+
+/*
+ * Reads a plain decimal number (no exponent, at most 15 digits) and returns
+ * the position after it, or null for anything else. The value is computed
+ * the way the rapidjson reader does it without kParseFullPrecisionFlag, so
+ * both paths give the same result.
+ */
+static const char *scanNumber(const char *p, const char *end, double &value)
+{
+    bool minus = isValid(p, end) && *p == '-';
+    if (minus) p++;
+    if (!isDigit(p, end)) return nullptr;
+
+    uint64_t significand = 0;
+    int      digits = 0;
+    int      fraction = 0;
+    if (*p == '0') {
+        p++;
+        digits++;
+    } else {
+        for (; isDigit(p, end); p++, digits++)
+            significand = significand * 10 + uint64_t(*p - '0');
+    }
+    if (isDigit(p, end)) return nullptr;
+
+    if (isValid(p, end) && *p == '.') {
+        if (!isDigit(++p, end)) return nullptr;
+        for (; isDigit(p, end); p++, digits++, fraction++)
+            significand = significand * 10 + uint64_t(*p - '0');
+    }
+    if (digits > 15 || (isValid(p, end) && (*p == 'e' || *p == 'E')))
+        return nullptr;
+
+    if (fraction) {
+        value = double(significand) / internal::Pow10(fraction);
+        if (minus) value = -value;
+    } else {
+        // integers are read as int, so "-0" gives 0.
+        value = minus ? double(-int64_t(significand)) : double(significand);
+    }
+    return p;
+}
+
+/*
+ * Reads the array of numbers the parser is entering straight from the json
+ * text into mNumbers and moves past it. Returns false without consuming
+ * anything when the array holds anything else than plain numbers, the
+ * caller then reads it token by token.
+ */
+bool LottieParserImpl::GetNumberArray()
+{
+    if (st_ != kEnteringArray) return false;
+
+    mNumbers.clear();
+    const char *end = dataEnd();
+    const char *p = skipSpace(position(), end);
+    while (isValid(p, end) && *p != ']') {
+        double value;
+        p = scanNumber(p, end, value);
+        if (!p) return false;
+        mNumbers.push_back(value);
+
+        p = skipSpace(p, end);
+        if (isValid(p, end) && *p == ',') {
+            p = skipSpace(p + 1, end);
+            if (isValid(p, end) && *p == ']') return false;
+        } else if (!isValid(p, end) || *p != ']') {
+            return false;
+        }
+    }
+    if (!isValid(p, end)) return false;
+
+    skipToClose(p);
+    return true;
+}
+
 void LottieParserImpl::Skip(const char * /*key*/)
 {
+    if (PeekType() == kArrayType || PeekType() == kObjectType) {
+        // jump to the closing bracket without dispatching the tokens of
+        // the value, the skipped data is not validated.
+        if (const char *close = scanClose(position(), dataEnd(), 1)) {
+            skipToClose(close);
+            return;
+        }
+    }
+
     if (PeekType() == kArrayType) {
         EnterArray();
         SkipArray();
@@ -542,6 +771,7 @@ void LottieParserImpl::resolveLayerRefs()
 {
     for (const auto &i : mLayersToUpdate) {
         LOTLayerData *layer = i.get();
+        // ref ids are interned so the lookup is by pointer.
         auto          search = compRef->mAssets.find(layer->extra()->mPreCompRefId);
         if (search != compRef->mAssets.end()) {
             if (layer->mLayerType == LayerType::Image) {
@@ -566,7 +796,7 @@ void LottieParserImpl::parseComposition()
     while (const char *key = NextObjectKey()) {
         if (0 == strcmp(key, "v")) {
             RAPIDJSON_ASSERT(PeekType() == kStringType);
-            comp->mVersion = std::string(GetString());
+            comp->mVersion = GetInternedString();
         } else if (0 == strcmp(key, "w")) {
             RAPIDJSON_ASSERT(PeekType() == kNumberType);
             comp->mSize.setWidth(GetInt());
@@ -596,7 +826,7 @@ void LottieParserImpl::parseComposition()
         }
     }
 
-    if (comp->mVersion.empty() || !comp->mRootLayer) {
+    if (!comp->mVersion || !comp->mVersion[0] || !comp->mRootLayer) {
         // don't have a valid bodymovin header
         return;
     }
@@ -652,6 +882,9 @@ void LottieParserImpl::parseMarkers()
 void LottieParserImpl::parseAssets(LOTCompositionData *composition)
 {
     RAPIDJSON_ASSERT(PeekType() == kArrayType);
+#ifdef LOTTIE_THREAD_SUPPORT
+    if (parseAssetsParallel(composition)) return;
+#endif
     EnterArray();
     while (NextArrayValue()) {
         std::shared_ptr<LOTAsset> asset = parseAsset();
@@ -660,6 +893,93 @@ void LottieParserImpl::parseAssets(LOTCompositionData *composition)
     // update the precomp layers with the actual layer object
 }
 
+/*
+ * Fast structural scan of an array of objects, starting right after its '['.
+ * Records the byte range of each object and returns the position of the
+ * closing ']', or null when the array holds anything else than objects.
+ * Strings are skipped without decoding them so the data is left untouched.
+ */
+static const char *scanObjectArray(
+    const char *p, const char *end,
+    std::vector<std::pair<const char *, const char *>> &ranges)
+{
+    p = skipSpace(p, end);
+    while (isValid(p, end) && *p == '{') {
+        const char *close = scanClose(p + 1, end, 1);
+        if (!close) return nullptr;
+        ranges.emplace_back(p, close + 1);
+
+        p = skipSpace(close + 1, end);
+        if (!isValid(p, end)) return nullptr;
+        if (*p == ']') return p;
+        if (*p != ',') return nullptr;
+        p = skipSpace(p + 1, end);
+    }
+    return (isValid(p, end) && *p == ']' && ranges.empty()) ? p : nullptr;
+}
+
+/*
+ * Assets are independent of each other, so when there is enough of them
+ * each one is parsed from its byte range by its own parser on the thread
+ * pool. The precomp references are resolved once the whole composition
+ * is parsed as usual.
+ */
+bool LottieParserImpl::parseAssetsParallel(LOTCompositionData *composition)
+{
+    static const size_t minParallelSize = 64 * 1024;
+
+    if (st_ != kEnteringArray ||
+        LottieTaskScheduler::instance().threadCount() < 2)
+        return false;
+
+    std::vector<std::pair<const char *, const char *>> ranges;
+
+    const char *arrayEnd = scanObjectArray(position(), dataEnd(), ranges);
+    if (!arrayEnd || ranges.size() < 2 ||
+        size_t(arrayEnd - position()) < minParallelSize)
+        return false;
+
+    struct Result {
+        std::shared_ptr<LOTAsset>                  asset;
+        std::vector<std::shared_ptr<LOTLayerData>> layersToUpdate;
+    };
+    std::vector<Result> results(ranges.size());
+
+    auto parse = [this](LottieParserImpl &parser, Result &result) {
+        parser.compRef = compRef;
+        if (!parser.ParseNext() || parser.PeekType() != kObjectType) return;
+        result.asset = parser.parseAsset();
+        result.layersToUpdate = std::move(parser.mLayersToUpdate);
+    };
+
+    compRef->mStringPool.setShared(true);
+    LottieTaskScheduler::instance().parallel(ranges.size(), [&](size_t i) {
+        const auto &range = ranges[i];
+        if (insitu_) {
+            // ranges don't overlap, so each parser modifies its own part.
+            LottieParserImpl parser(const_cast<char *>(range.first),
+                                    mDirPath.c_str());
+            parse(parser, results[i]);
+        } else {
+            LottieParserImpl parser(range.first,
+                                    size_t(range.second - range.first),
+                                    mDirPath.c_str());
+            parse(parser, results[i]);
+        }
+    });
+    compRef->mStringPool.setShared(false);
+
+    for (auto &result : results) {
+        if (!result.asset) continue;
+        composition->mAssets[result.asset->mRefId] = result.asset;
+        std::move(result.layersToUpdate.begin(), result.layersToUpdate.end(),
+                  std::back_inserter(mLayersToUpdate));
+    }
+
+    skipToClose(arrayEnd);
+    return true;
+}
+
 static constexpr const unsigned char B64index[256] = {
     0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
     0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
@@ -695,17 +1015,15 @@ std::string b64decode(const char *data, const size_t len)
     return str;
 }
 
-static std::string convertFromBase64(const std::string &str)
+static std::string convertFromBase64(const char *str)
 {
     // usual header look like "data:image/png;base64,"
     // so need to skip till ','.
-    size_t startIndex = str.find(",", 0);
-    startIndex += 1;  // skip ","
-    size_t length = str.length() - startIndex;
+    const char *b64Data = strchr(str, ',');
+    if (!b64Data) return std::string();
+    b64Data += 1;  // skip ","
 
-    const char *b64Data = str.c_str() + startIndex;
-
-    return b64decode(b64Data, length);
+    return b64decode(b64Data, strlen(b64Data));
 }
 
 /*
@@ -729,8 +1047,9 @@ std::shared_ptr<LOTAsset> LottieParserImpl::parseAsset()
     RAPIDJSON_ASSERT(PeekType() == kObjectType);
     std::shared_ptr<LOTAsset> sharedAsset = std::make_shared<LOTAsset>();
     LOTAsset *                asset = sharedAsset.get();
-    std::string               filename;
-    std::string               relativePath;
+    // strings are pointing to the insitu json buffer.
+    const char *              filename = "";
+    const char *              relativePath = "";
     bool                      embededResource = false;
     EnterObject();
     while (const char *key = NextObjectKey()) {
@@ -743,18 +1062,18 @@ std::shared_ptr<LOTAsset> LottieParserImpl::parseAsset()
         } else if (0 == strcmp(key, "p")) { /* image name */
             asset->mAssetType = LOTAsset::Type::Image;
             RAPIDJSON_ASSERT(PeekType() == kStringType);
-            filename = std::string(GetString());
+            filename = GetString();
         } else if (0 == strcmp(key, "u")) { /* relative image path */
             RAPIDJSON_ASSERT(PeekType() == kStringType);
-            relativePath = std::string(GetString());
+            relativePath = GetString();
         } else if (0 == strcmp(key, "e")) { /* relative image path */
             embededResource = GetInt();
         } else if (0 == strcmp(key, "id")) { /* reference id*/
             if (PeekType() == kStringType) {
-                asset->mRefId = std::string(GetString());
+                asset->mRefId = GetInternedString();
             } else {
                 RAPIDJSON_ASSERT(PeekType() == kNumberType);
-                asset->mRefId = toString(GetInt());
+                asset->mRefId = compRef->mStringPool.intern(toString(GetInt()));
             }
         } else if (0 == strcmp(key, "layers")) {
             asset->mAssetType = LOTAsset::Type::Precomp;
@@ -780,7 +1099,7 @@ std::shared_ptr<LOTAsset> LottieParserImpl::parseAsset()
     if (asset->mAssetType == LOTAsset::Type::Image) {
         if (embededResource) {
             // embeder resource should start with "data:"
-            if (filename.compare(0, 5, "data:") == 0) {
+            if (strncmp(filename, "data:", 5) == 0) {
                 asset->loadImageData(convertFromBase64(filename));
             }
         } else {
@@ -795,7 +1114,7 @@ void LottieParserImpl::parseLayers(LOTCompositionData *comp)
 {
     comp->mRootLayer = std::make_shared<LOTLayerData>();
     comp->mRootLayer->mLayerType = LayerType::Precomp;
-    comp->mRootLayer->setName("__");
+    comp->mRootLayer->setName("__", comp->mStringPool);
     bool staticFlag = true;
     RAPIDJSON_ASSERT(PeekType() == kArrayType);
     EnterArray();
@@ -902,7 +1221,7 @@ std::shared_ptr<LOTData> LottieParserImpl::parseLayer(bool record)
             layer->mLayerType = getLayerType();
         } else if (0 == strcmp(key, "nm")) { /*Layer name*/
             RAPIDJSON_ASSERT(PeekType() == kStringType);
-            layer->setName(GetString());
+            layer->setName(GetString(), compRef->mStringPool);
         } else if (0 == strcmp(key, "ind")) { /*Layer index in AE. Used for
                                                  parenting and expressions.*/
             RAPIDJSON_ASSERT(PeekType() == kNumberType);
@@ -917,7 +1236,7 @@ std::shared_ptr<LOTData> LottieParserImpl::parseLayer(bool record)
             layer->mParentId = GetInt();
         } else if (0 == strcmp(key, "refId")) { /*preComp Layer reference id*/
             RAPIDJSON_ASSERT(PeekType() == kStringType);
-            layer->extra()->mPreCompRefId = std::string(GetString());
+            layer->extra()->mPreCompRefId = GetInternedString();
             layer->mHasGradient = true;
             mLayersToUpdate.push_back(sharedLayer);
         } else if (0 == strcmp(key, "sr")) {  // "Layer Time Stretching"
@@ -1142,7 +1461,7 @@ std::shared_ptr<LOTData> LottieParserImpl::parseGroupObject()
     LOTShapeGroupData *group = sharedGroup.get();
     while (const char *key = NextObjectKey()) {
         if (0 == strcmp(key, "nm")) {
-            group->setName(GetString());
+            group->setName(GetString(), compRef->mStringPool);
         } else if (0 == strcmp(key, "it")) {
             RAPIDJSON_ASSERT(PeekType() == kArrayType);
             EnterArray();
@@ -1181,7 +1500,7 @@ std::shared_ptr<LOTData> LottieParserImpl::parseRectObject()
 
     while (const char *key = NextObjectKey()) {
         if (0 == strcmp(key, "nm")) {
-            obj->setName(GetString());
+            obj->setName(GetString(), compRef->mStringPool);
         } else if (0 == strcmp(key, "p")) {
             parseProperty(obj->mPos);
         } else if (0 == strcmp(key, "s")) {
@@ -1212,7 +1531,7 @@ std::shared_ptr<LOTData> LottieParserImpl::parseEllipseObject()
 
     while (const char *key = NextObjectKey()) {
         if (0 == strcmp(key, "nm")) {
-            obj->setName(GetString());
+            obj->setName(GetString(), compRef->mStringPool);
         } else if (0 == strcmp(key, "p")) {
             parseProperty(obj->mPos);
         } else if (0 == strcmp(key, "s")) {
@@ -1240,7 +1559,7 @@ std::shared_ptr<LOTData> LottieParserImpl::parseShapeObject()
 
     while (const char *key = NextObjectKey()) {
         if (0 == strcmp(key, "nm")) {
-            obj->setName(GetString());
+            obj->setName(GetString(), compRef->mStringPool);
         } else if (0 == strcmp(key, "ks")) {
             parseShapeProperty(obj->mShape);
         } else if (0 == strcmp(key, "d")) {
@@ -1270,7 +1589,7 @@ std::shared_ptr<LOTData> LottieParserImpl::parsePolystarObject()
 
     while (const char *key = NextObjectKey()) {
         if (0 == strcmp(key, "nm")) {
-            obj->setName(GetString());
+            obj->setName(GetString(), compRef->mStringPool);
         } else if (0 == strcmp(key, "p")) {
             parseProperty(obj->mPos);
         } else if (0 == strcmp(key, "pt")) {
@@ -1336,7 +1655,7 @@ std::shared_ptr<LOTData> LottieParserImpl::parseTrimObject()
 
     while (const char *key = NextObjectKey()) {
         if (0 == strcmp(key, "nm")) {
-            obj->setName(GetString());
+            obj->setName(GetString(), compRef->mStringPool);
         } else if (0 == strcmp(key, "s")) {
             parseProperty(obj->mStart);
         } else if (0 == strcmp(key, "e")) {
@@ -1390,7 +1709,7 @@ std::shared_ptr<LOTData> LottieParserImpl::parseReapeaterObject()
 
     while (const char *key = NextObjectKey()) {
         if (0 == strcmp(key, "nm")) {
-            obj->setName(GetString());
+            obj->setName(GetString(), compRef->mStringPool);
         } else if (0 == strcmp(key, "c")) {
             parseProperty(obj->mCopies);
             float maxCopy = 0.0;
@@ -1441,7 +1760,7 @@ std::shared_ptr<LOTTransformData> LottieParserImpl::parseTransformObject(
 
     while (const char *key = NextObjectKey()) {
         if (0 == strcmp(key, "nm")) {
-            sharedTransform->setName(GetString());
+            sharedTransform->setName(GetString(), compRef->mStringPool);
         } else if (0 == strcmp(key, "a")) {
             parseProperty(obj->mAnchor);
         } else if (0 == strcmp(key, "p")) {
@@ -1507,7 +1826,7 @@ std::shared_ptr<LOTData> LottieParserImpl::parseFillObject()
 
     while (const char *key = NextObjectKey()) {
         if (0 == strcmp(key, "nm")) {
-            obj->setName(GetString());
+            obj->setName(GetString(), compRef->mStringPool);
         } else if (0 == strcmp(key, "c")) {
             parseProperty(obj->mColor);
         } else if (0 == strcmp(key, "o")) {
@@ -1595,7 +1914,7 @@ std::shared_ptr<LOTData> LottieParserImpl::parseStrokeObject()
 
     while (const char *key = NextObjectKey()) {
         if (0 == strcmp(key, "nm")) {
-            obj->setName(GetString());
+            obj->setName(GetString(), compRef->mStringPool);
         } else if (0 == strcmp(key, "c")) {
             parseProperty(obj->mColor);
         } else if (0 == strcmp(key, "o")) {
@@ -1678,7 +1997,7 @@ std::shared_ptr<LOTData> LottieParserImpl::parseGFillObject()
 
     while (const char *key = NextObjectKey()) {
         if (0 == strcmp(key, "nm")) {
-            obj->setName(GetString());
+            obj->setName(GetString(), compRef->mStringPool);
         } else if (0 == strcmp(key, "r")) {
             obj->mFillRule = getFillRule();
         } else {
@@ -1717,7 +2036,7 @@ std::shared_ptr<LOTData> LottieParserImpl::parseGStrokeObject()
 
     while (const char *key = NextObjectKey()) {
         if (0 == strcmp(key, "nm")) {
-            obj->setName(GetString());
+            obj->setName(GetString(), compRef->mStringPool);
         } else if (0 == strcmp(key, "w")) {
             parseProperty(obj->mWidth);
         } else if (0 == strcmp(key, "lc")) {
@@ -1745,7 +2064,6 @@ void LottieParserImpl::getValue(std::vector<VPointF> &v)
     EnterArray();
     while (NextArrayValue()) {
         RAPIDJSON_ASSERT(PeekType() == kArrayType);
-        EnterArray();
         VPointF pt;
         getValue(pt);
         v.push_back(pt);
@@ -1757,12 +2075,16 @@ void LottieParserImpl::getValue(VPointF &pt)
     float val[4] = {0.f};
     int   i = 0;
 
-    if (PeekType() == kArrayType) EnterArray();
+    if (GetNumberArray()) {
+        for (; i < 4 && size_t(i) < mNumbers.size(); i++) val[i] = mNumbers[i];
+    } else {
+        if (PeekType() == kArrayType) EnterArray();
 
-    while (NextArrayValue()) {
-        const auto value = GetDouble();
-        if (i < 4) {
-            val[i++] = value;
+        while (NextArrayValue()) {
+            const auto value = GetDouble();
+            if (i < 4) {
+                val[i++] = value;
+            }
         }
     }
     pt.setX(val[0]);
@@ -1771,7 +2093,9 @@ void LottieParserImpl::getValue(VPointF &pt)
 
 void LottieParserImpl::getValue(float &val)
 {
-    if (PeekType() == kArrayType) {
+    if (GetNumberArray()) {
+        if (!mNumbers.empty()) val = mNumbers[0];
+    } else if (PeekType() == kArrayType) {
         EnterArray();
         if (NextArrayValue()) val = GetDouble();
         // discard rest
@@ -1789,12 +2113,16 @@ void LottieParserImpl::getValue(LottieColor &color)
 {
     float val[4] = {0.f};
     int   i = 0;
-    if (PeekType() == kArrayType) EnterArray();
+    if (GetNumberArray()) {
+        for (; i < 4 && size_t(i) < mNumbers.size(); i++) val[i] = mNumbers[i];
+    } else {
+        if (PeekType() == kArrayType) EnterArray();
 
-    while (NextArrayValue()) {
-        const auto value = GetDouble();
-        if (i < 4) {
-            val[i++] = value;
+        while (NextArrayValue()) {
+            const auto value = GetDouble();
+            if (i < 4) {
+                val[i++] = value;
+            }
         }
     }
     color.r = val[0];
@@ -1804,6 +2132,12 @@ void LottieParserImpl::getValue(LottieColor &color)
 
 void LottieParserImpl::getValue(LottieGradient &grad)
 {
+    if (GetNumberArray()) {
+        grad.mGradient.insert(grad.mGradient.end(), mNumbers.cbegin(),
+                              mNumbers.cend());
+        return;
+    }
+
     if (PeekType() == kArrayType) EnterArray();
 
     while (NextArrayValue()) {
@@ -1950,8 +2284,7 @@ std::shared_ptr<VInterpolator> LottieParserImpl::interpolator(
         return search->second;
     }
 
-    auto obj = std::make_shared<VInterpolator>(
-        VInterpolator(outTangent, inTangent));
+    auto obj = LOTInterpolatorPool::intern(outTangent, inTangent);
     mInterpolatorCache[std::move(key)] = obj;
     return obj;
 }
@@ -2030,6 +2363,10 @@ void LottieParserImpl::parseKeyFrame(LOTAnimInfo<T> &obj)
             obj.mKeyFrames.back().mValue.mEndValue =
                 keyframe.mValue.mStartValue;
         }
+        // the frame range and the values of the previous keyframe
+        // are known now.
+        LOTInterpolatorPool::bake(obj.mKeyFrames.back());
+        obj.mKeyFrames.back().mValue.cacheArcLengths();
     }
 
     if (parsed.hold) {
@@ -2314,6 +2651,15 @@ LottieParser::LottieParser(char *str, const char *dir_path)
         vWarning << "Input data is not Lottie format!";
 }
 
+LottieParser::LottieParser(const char *data, size_t size, const char *dir_path)
+    : d(std::make_unique<LottieParserImpl>(data, size, dir_path))
+{
+    if (d->VerifyType())
+        d->parseComposition();
+    else
+        vWarning << "Input data is not Lottie format!";
+}
+
 std::shared_ptr<LOTModel> LottieParser::model()
 {
     if (!d->composition()) return nullptr;
@@ -2321,8 +2667,17 @@ std::shared_ptr<LOTModel> LottieParser::model()
     std::shared_ptr<LOTModel> model = std::make_shared<LOTModel>();
     model->mRoot = d->composition();
     model->mRoot->processRepeaterObjects();
+    model->mRoot->optimize();
     model->mRoot->updateStats();
 
+    const auto &stats = model->mRoot->mStats;
+    vDebug << "model optimized, removed: " << stats.hiddenObjects
+           << " hidden objects, " << stats.emptyGroups << " empty groups, "
+           << stats.identityTransforms << " identity transforms, "
+           << stats.culledLayers << " invisible layers, merged: "
+           << stats.mergedGroups << " groups, static: "
+           << stats.staticProperties << " properties";
+
 
 #ifdef LOTTIE_DUMP_TREE_SUPPORT
     LOTDataInspector inspector;
@@ -27,6 +27,8 @@ class LottieParser {
 public:
     ~LottieParser();
     LottieParser(char* str, const char *dir_path);
+    // parses read only data without modifying it.
+    LottieParser(const char *data, size_t size, const char *dir_path);
     std::shared_ptr<LOTModel> model();
 private:
    std::unique_ptr<LottieParserImpl>  d;
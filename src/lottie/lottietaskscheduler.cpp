@@ -0,0 +1,166 @@
+/*
+ * Copyright (c) 2018 Samsung Electronics Co., Ltd. All rights reserved.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA
+ */
+
+#include "lottietaskscheduler.h"
+#include "config.h"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+
+#ifdef LOTTIE_THREAD_SUPPORT
+
+#include <thread>
+#include <vector>
+#include "vtaskqueue.h"
+
+/*
+ * Implement a task stealing schduler to perform the tasks.
+ * The scheduler creates a threadpool depending on the number of cores
+ * available in the system and does a simple fair scheduling by assigning
+ * the task in a round-robin fashion. Each thread in the threadpool has its
+ * own queue. once it finishes all the task on its own queue it goes through
+ * rest of the queue and looks for task if it founds one it steals the task
+ * from it and executes. if it couldn't find one then it just waits for new
+ * task on its own queue.
+ */
+class LottieTaskScheduler::Impl {
+    using Task = LottieTaskScheduler::Task;
+
+    const unsigned                _count{std::thread::hardware_concurrency()};
+    std::vector<std::thread>      _threads;
+    std::vector<TaskQueue<Task>>  _q{_count};
+    std::atomic<unsigned>         _index{0};
+
+    void run(unsigned i)
+    {
+        while (true) {
+            bool success = false;
+            Task task;
+            for (unsigned n = 0; n != _count * 32; ++n) {
+                if (_q[(i + n) % _count].try_pop(task)) {
+                    success = true;
+                    break;
+                }
+            }
+            if (!success && !_q[i].pop(task)) break;
+
+            task();
+        }
+    }
+
+public:
+    Impl()
+    {
+        for (unsigned n = 0; n != _count; ++n) {
+            _threads.emplace_back([&, n] { run(n); });
+        }
+    }
+
+    ~Impl()
+    {
+        for (auto &e : _q) e.done();
+
+        for (auto &e : _threads) e.join();
+    }
+
+    unsigned count() const { return _count; }
+
+    void process(Task task)
+    {
+        if (!_count) return task();
+
+        auto i = _index++;
+
+        for (unsigned n = 0; n != _count; ++n) {
+            if (_q[(i + n) % _count].try_push(std::move(task))) return;
+        }
+
+        _q[i % _count].push(std::move(task));
+    }
+};
+
+#else
+
+class LottieTaskScheduler::Impl {
+public:
+    unsigned count() const { return 0; }
+    void     process(LottieTaskScheduler::Task task) { task(); }
+};
+
+#endif
+
+LottieTaskScheduler &LottieTaskScheduler::instance()
+{
+    static LottieTaskScheduler singleton;
+    return singleton;
+}
+
+LottieTaskScheduler::LottieTaskScheduler() : d(std::make_unique<Impl>()) {}
+
+LottieTaskScheduler::~LottieTaskScheduler() = default;
+
+void LottieTaskScheduler::process(Task task)
+{
+    d->process(std::move(task));
+}
+
+unsigned LottieTaskScheduler::threadCount() const
+{
+    return d->count();
+}
+
+void LottieTaskScheduler::parallel(size_t                             count,
+                                   const std::function<void(size_t)> &fn)
+{
+    // shared with the helper tasks which may outlive this call, they only
+    // touch fn after claiming an index which this call waits for.
+    struct Job {
+        std::atomic<size_t>                 next{0};
+        std::atomic<size_t>                 done{0};
+        size_t                              count{0};
+        const std::function<void(size_t)> *fn{nullptr};
+        std::mutex                          mutex;
+        std::condition_variable             finished;
+
+        void work()
+        {
+            size_t i;
+            while ((i = next++) < count) {
+                (*fn)(i);
+                if (++done == count) {
+                    { std::lock_guard<std::mutex> lock(mutex); }
+                    finished.notify_all();
+                }
+            }
+        }
+    };
+
+    auto job = std::make_shared<Job>();
+    job->count = count;
+    job->fn = &fn;
+
+    size_t helpers = count ? std::min<size_t>(d->count(), count - 1) : 0;
+    for (size_t i = 0; i < helpers; i++) d->process([job] { job->work(); });
+
+    job->work();
+
+    std::unique_lock<std::mutex> lock(job->mutex);
+    job->finished.wait(lock, [&job] { return job->done == job->count; });
+}
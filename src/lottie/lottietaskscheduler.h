@@ -0,0 +1,55 @@
+/*
+ * Copyright (c) 2018 Samsung Electronics Co., Ltd. All rights reserved.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA
+ */
+
+#ifndef LOTTIETASKSCHEDULER_H
+#define LOTTIETASKSCHEDULER_H
+
+#include <functional>
+#include <memory>
+
+/*
+ * Process wide thread pool shared by the render and the load tasks.
+ * When the library is built without thread support the tasks are
+ * executed synchronously by the caller.
+ */
+class LottieTaskScheduler {
+public:
+    using Task = std::function<void()>;
+
+    static LottieTaskScheduler &instance();
+    ~LottieTaskScheduler();
+
+    void process(Task task);
+
+    // number of threads in the pool, 0 without thread support.
+    unsigned threadCount() const;
+
+    /*
+     * Runs fn(0) ... fn(count - 1) on the pool and returns once all of them
+     * are finished. The calling thread takes part in the work so it is safe
+     * to call from a task that is already running on the pool.
+     */
+    void parallel(size_t count, const std::function<void(size_t)> &fn);
+
+private:
+    LottieTaskScheduler();
+    class Impl;
+    std::unique_ptr<Impl> d;
+};
+
+#endif  // LOTTIETASKSCHEDULER_H
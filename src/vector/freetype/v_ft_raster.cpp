@@ -913,29 +913,31 @@ static void gray_hline(RAS_ARG_ TCoord x, TCoord y, TPos area, TCoord acount)
     y += (TCoord)ras.min_ey;
     x += (TCoord)ras.min_ex;
 
-    /* SW_FT_Span.x is a 16-bit short, so limit our coordinates appropriately */
-    if (x >= 32767) x = 32767;
-
-    /* SW_FT_Span.y is an integer, so limit our coordinates appropriately */
+    /* SW_FT_Span.x and y are integers, limit our coordinates appropriately */
+    if (x >= SW_FT_INT_MAX) x = SW_FT_INT_MAX;
     if (y >= SW_FT_INT_MAX) y = SW_FT_INT_MAX;
 
-    if (coverage) {
+    /* SW_FT_Span.len is a 16-bit unsigned short, longer runs are split */
+    while (coverage && acount > 0) {
         SW_FT_Span* span;
         int         count;
+        TCoord      len = acount > 0xFFFF ? 0xFFFF : acount;
 
         // update bounding box.
         if (x < ras.bound_left) ras.bound_left = x;
         if (y < ras.bound_top) ras.bound_top = y;
         if (y > ras.bound_bottom) ras.bound_bottom = y;
-        if (x + acount > ras.bound_right) ras.bound_right = x + acount;
+        if (x + len > ras.bound_right) ras.bound_right = x + len;
 
         /* see whether we can add this span to the current list */
         count = ras.num_gray_spans;
         span = ras.gray_spans + count - 1;
         if (count > 0 && span->y == y && (int)span->x + span->len == (int)x &&
-            span->coverage == coverage) {
-            span->len = (unsigned short)(span->len + acount);
-            return;
+            span->coverage == coverage && span->len + len <= 0xFFFF) {
+            span->len = (unsigned short)(span->len + len);
+            x += len;
+            acount -= len;
+            continue;
         }
 
         if (count >= SW_FT_MAX_GRAY_SPANS) {
@@ -964,12 +966,14 @@ static void gray_hline(RAS_ARG_ TCoord x, TCoord y, TPos area, TCoord acount)
             span++;
 
         /* add a gray span to the current list */
-        span->x = (short)x;
-        span->y = (short)y;
-        span->len = (unsigned short)acount;
+        span->x = (int)x;
+        span->y = (int)y;
+        span->len = (unsigned short)len;
         span->coverage = (unsigned char)coverage;
 
         ras.num_gray_spans++;
+        x += len;
+        acount -= len;
     }
 }
 
@@ -1402,10 +1406,11 @@ static int gray_raster_render(gray_PRaster               raster,
     if (params->flags & SW_FT_RASTER_FLAG_CLIP)
         ras.clip_box = params->clip_box;
     else {
-        ras.clip_box.xMin = -32768L;
-        ras.clip_box.yMin = -32768L;
-        ras.clip_box.xMax = 32767L;
-        ras.clip_box.yMax = 32767L;
+        /* largest pixel range whose 24.8 sub-pixel position fits an int */
+        ras.clip_box.xMin = -(SW_FT_INT_MAX >> PIXEL_BITS);
+        ras.clip_box.yMin = -(SW_FT_INT_MAX >> PIXEL_BITS);
+        ras.clip_box.xMax = SW_FT_INT_MAX >> PIXEL_BITS;
+        ras.clip_box.yMax = SW_FT_INT_MAX >> PIXEL_BITS;
     }
 
     gray_init_cells(RAS_VAR_ buffer, buffer_size);
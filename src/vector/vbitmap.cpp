@@ -105,7 +105,7 @@ VBitmap::VBitmap(size_t width, size_t height, VBitmap::Format format)
 {
     if (width <= 0 || height <= 0 || format == Format::Invalid) return;
 
-    mImpl = rc_ptr<Impl>(width, height, format);
+    mImpl = arc_ptr<Impl>(width, height, format);
 }
 
 VBitmap::VBitmap(uchar *data, size_t width, size_t height, size_t bytesPerLine,
@@ -115,7 +115,7 @@ VBitmap::VBitmap(uchar *data, size_t width, size_t height, size_t bytesPerLine,
         format == Format::Invalid)
         return;
 
-    mImpl = rc_ptr<Impl>(data, width, height, bytesPerLine, format);
+    mImpl = arc_ptr<Impl>(data, width, height, bytesPerLine, format);
 }
 
 void VBitmap::reset(uchar *data, size_t w, size_t h, size_t bytesPerLine,
@@ -124,7 +124,7 @@ void VBitmap::reset(uchar *data, size_t w, size_t h, size_t bytesPerLine,
     if (mImpl) {
         mImpl->reset(data, w, h, bytesPerLine, format);
     } else {
-        mImpl = rc_ptr<Impl>(data, w, h, bytesPerLine, format);
+        mImpl = arc_ptr<Impl>(data, w, h, bytesPerLine, format);
     }
 }
 
@@ -137,7 +137,7 @@ void VBitmap::reset(size_t w, size_t h, VBitmap::Format format)
         }
         mImpl->reset(w, h, format);
     } else {
-        mImpl = rc_ptr<Impl>(w, h, format);
+        mImpl = arc_ptr<Impl>(w, h, format);
     }
 }
 
@@ -82,7 +82,7 @@ private:
         void updateLuma();
     };
 
-    rc_ptr<Impl> mImpl;
+    arc_ptr<Impl> mImpl;
 };
 
 V_END_NAMESPACE
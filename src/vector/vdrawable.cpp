@@ -17,22 +17,106 @@
  */
 
 #include "vdrawable.h"
+#include <algorithm>
+#include <climits>
+#include <cmath>
 #include "vdasher.h"
 #include "vraster.h"
 
-void VDrawable::preprocess(const VRect &clip)
+/*
+ * conservative device space bounds of the drawable, the control points
+ * of the path grown by the stroke extent and one pixel of antialiasing.
+ */
+VRect VDrawable::bounds() const
+{
+    VRectF box = mPath.boundingRect();
+    if (mPath.empty()) return {};
+
+    if (!mMatrix.isIdentity()) {
+        VPointF p1 = mMatrix.map(box.left(), box.top());
+        VPointF p2 = mMatrix.map(box.right(), box.top());
+        VPointF p3 = mMatrix.map(box.left(), box.bottom());
+        VPointF p4 = mMatrix.map(box.right(), box.bottom());
+        float   left = std::min({p1.x(), p2.x(), p3.x(), p4.x()});
+        float   top = std::min({p1.y(), p2.y(), p3.y(), p4.y()});
+        float   right = std::max({p1.x(), p2.x(), p3.x(), p4.x()});
+        float   bottom = std::max({p1.y(), p2.y(), p3.y(), p4.y()});
+        box = VRectF(left, top, right - left, bottom - top);
+    }
+
+    float extent = 1;
+    if (mStroke.enable) {
+        // miter joins can reach miterLimit * width / 2 away from the path,
+        // square caps width / sqrt(2).
+        float factor = 1.5f;
+        if (mStroke.join == JoinStyle::Miter)
+            factor = std::max(factor, mStroke.miterLimit);
+        extent += mStroke.width * 0.5f * factor;
+    }
+    return VRectF(box.left() - extent, box.top() - extent,
+                  box.width() + 2 * extent, box.height() + 2 * extent)
+        .toAlignedRect();
+}
+
+void VDrawable::preprocess(const VRect &clip, const VRect &visibleRect)
 {
+    if (mFlag & (DirtyState::Path)) mBounds = bounds();
+
+    mClip = clip;
+    mCulled = !mBounds.intersects(visibleRect);
+    if (mCulled) return;
+
+    // the source is preprocessed first, its rle can be used when it is
+    // complete and the copy needs no clipping. The path is kept in case
+    // the copy has to be rasterized on its own in a later frame.
+    mInstanced = mSource && !mSource->mCulled && !mSource->mClipped &&
+                 clip.contains(mBounds) &&
+                 mSource->mBounds.translated(mOffset.x(), mOffset.y()) ==
+                     mBounds;
+    if (mInstanced) return;
+
     if (mFlag & (DirtyState::Path)) {
-        if (mStroke.enable) {
-            if (mStroke.mDash.size()) {
-                VDasher dasher(mStroke.mDash.data(), mStroke.mDash.size());
-                mPath.clone(dasher.dashed(mPath));
-            }
-            mRasterizer.rasterize(std::move(mPath), mStroke.cap, mStroke.join,
-                                  mStroke.width, mStroke.miterLimit, clip);
+        // no need to clip when the drawable is fully inside, or when
+        // other drawables share its rle and it fits in the raster range.
+        static const int   range = INT_MAX >> 8;
+        static const VRect rasterRange(-range, -range, 2 * range, 2 * range);
+        bool unclipped = clip.contains(mBounds) ||
+                         (mShared && rasterRange.contains(mBounds));
+        VRect rasterClip = unclipped ? VRect() : clip;
+        // an unclipped rle that moved by exactly whole pixels only has to
+        // be shifted. Any fraction moves the points against the 1/64 pixel
+        // grid of the raster, the rle would then differ from the one of
+        // the path rasterized at its new position.
+        VPoint offset(int(std::round(mPathOffset.x())),
+                      int(std::round(mPathOffset.y())));
+        bool moved = mMovable && mRasterizer.hasRle() && !mClipped &&
+                     unclipped && mPathOffset.x() == float(offset.x()) &&
+                     mPathOffset.y() == float(offset.y());
+        if (moved) {
+            mRasterizer.translate(offset);
         } else {
-            mRasterizer.rasterize(std::move(mPath), mFillRule, clip);
+            VMatrix m = mMatrix;
+            if (mStroke.enable) {
+                // the dash pattern is in device co-ordinates.
+                if (mStroke.mDash.size()) {
+                    if (!m.isIdentity()) {
+                        mPath.transform(m);
+                        m = VMatrix();
+                    }
+                    VDasher dasher(mStroke.mDash.data(), mStroke.mDash.size());
+                    mPath.clone(dasher.dashed(mPath));
+                }
+                mRasterizer.rasterize(std::move(mPath), m, mStroke.cap,
+                                      mStroke.join, mStroke.width,
+                                      mStroke.miterLimit, rasterClip);
+            } else {
+                mRasterizer.rasterize(std::move(mPath), m, mFillRule,
+                                      rasterClip);
+            }
         }
+        mPathOffset = {};
+        mClipped = !unclipped;
+        mMovable = true;
         mPath = {};
         mFlag &= ~DirtyFlag(DirtyState::Path);
     }
@@ -40,9 +124,25 @@ void VDrawable::preprocess(const VRect &clip)
 
 VRle VDrawable::rle()
 {
+    if (mCulled) return VRle();
+    if (mInstanced) {
+        VRle rle = mSource->mRasterizer.rle();
+        rle.translate(mOffset);
+        return rle;
+    }
+    // a shared rle can reach outside of the clip.
+    if (!mClipped && !mClip.contains(mBounds))
+        return mRasterizer.rle() & VRle::toRle(mClip);
     return mRasterizer.rle();
 }
 
+void VDrawable::setSource(VDrawable *source, const VPoint &offset)
+{
+    mSource = source;
+    mOffset = offset;
+    if (!mSource) mInstanced = false;
+}
+
 void VDrawable::setStrokeInfo(CapStyle cap, JoinStyle join, float miterLimit,
                               float strokeWidth)
 {
@@ -57,6 +157,7 @@ void VDrawable::setStrokeInfo(CapStyle cap, JoinStyle join, float miterLimit,
     mStroke.miterLimit = miterLimit;
     mStroke.width = strokeWidth;
     mFlag |= DirtyState::Path;
+    mMovable = false;
 }
 
 void VDrawable::setDashInfo(std::vector<float> &dashInfo)
@@ -79,10 +180,22 @@ void VDrawable::setDashInfo(std::vector<float> &dashInfo)
     mStroke.mDash = dashInfo;
 
     mFlag |= DirtyState::Path;
+    mMovable = false;
+}
+
+void VDrawable::setPath(const VPath &path, const VMatrix &m)
+{
+    mPath = path;
+    mMatrix = m;
+    mFlag |= DirtyState::Path;
+    mMovable = false;
 }
 
-void VDrawable::setPath(const VPath &path)
+void VDrawable::setPath(const VPath &path, const VMatrix &m,
+                        const VPointF &offset)
 {
     mPath = path;
+    mMatrix = m;
     mFlag |= DirtyState::Path;
+    mPathOffset += offset;
 }
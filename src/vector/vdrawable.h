@@ -20,6 +20,7 @@
 #define VDRAWABLE_H
 #include <future>
 #include "vbrush.h"
+#include "vmatrix.h"
 #include "vpath.h"
 #include "vrle.h"
 #include "vraster.h"
@@ -38,14 +39,38 @@ public:
         Stroke,
     };
     typedef vFlag<DirtyState> DirtyFlag;
-    void setPath(const VPath &path);
+    /*
+     * the path is drawn mapped by m, the points are only transformed
+     * while the rasterizer converts them.
+     */
+    void setPath(const VPath &path, const VMatrix &m = VMatrix());
+    /*
+     * same as setPath() for a path that is the last one moved by offset,
+     * the existing rle is moved along instead of rasterizing the path
+     * again as long as the total offset stays on whole pixels.
+     */
+    void setPath(const VPath &path, const VMatrix &m, const VPointF &offset);
     void setFillRule(FillRule rule) { mFillRule = rule; }
     void setBrush(const VBrush &brush) { mBrush = brush; }
     void setStrokeInfo(CapStyle cap, JoinStyle join, float miterLimit,
                        float strokeWidth);
     void setDashInfo(std::vector<float> &dashInfo);
-    void preprocess(const VRect &clip);
+    /*
+     * reuse the rle of source moved by offset instead of rasterizing
+     * this drawable, used for copies that only differ by a translation.
+     * The source has to be marked as shared so that it gets rasterized
+     * without a clip. Pass nullptr to rasterize the drawable again.
+     */
+    void setSource(VDrawable *source, const VPoint &offset);
+    /*
+     * clip is the area the rasterizer has to clip to and visibleRect the
+     * part of it where the drawable can still show up (after the layer
+     * masks and precomp clippers). A drawable whose bounds miss the
+     * visibleRect is not rasterized and keeps its path for the next frame.
+     */
+    void preprocess(const VRect &clip, const VRect &visibleRect);
     VRle rle();
+    bool culled() const { return mCulled; }
 
 public:
     struct StrokeInfo {
@@ -59,10 +84,24 @@ public:
     VRasterizer       mRasterizer;
     VBrush            mBrush;
     VPath             mPath;
+    VMatrix           mMatrix;
     StrokeInfo        mStroke;
     DirtyFlag         mFlag{DirtyState::All};
     FillRule          mFillRule{FillRule::Winding};
     VDrawable::Type   mType{Type::Fill};
+    VRect             mBounds;
+    VRect             mClip;
+    VDrawable        *mSource{nullptr};
+    VPoint            mOffset;
+    VPointF           mPathOffset;
+    bool              mCulled{false};
+    bool              mClipped{false};
+    bool              mShared{false};
+    bool              mInstanced{false};
+    bool              mMovable{false};
+
+private:
+    VRect bounds() const;
 };
 
 #endif  // VDRAWABLE_H
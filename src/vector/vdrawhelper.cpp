@@ -117,6 +117,14 @@ public:
          return CACHE;
       }
 
+    size_t release()
+    {
+        std::lock_guard<std::mutex> guard(mMutex);
+        size_t bytes = mCache.size() * sizeof(CacheInfo);
+        mCache.clear();
+        return bytes;
+    }
+
 protected:
     uint       maxCacheSize() const { return 60; }
     VCacheData addCacheElement(VCacheKey hash_val, const VGradient &gradient)
@@ -142,6 +150,11 @@ private:
     std::mutex              mMutex;
 };
 
+size_t vReleaseGradientCache()
+{
+    return VGradientCache::instance().release();
+}
+
 bool VGradientCache::generateGradientColorTable(const VGradientStops &stops,
                                                 float                 opacity,
                                                 uint32_t *colorTable, int size)
@@ -192,6 +192,7 @@ struct VSpanData {
 };
 
 void        vInitDrawhelperFunctions();
+size_t      vReleaseGradientCache();
 extern void vInitBlendFunctions();
 
 #define BYTE_MUL(c, a)                                  \
@@ -82,6 +82,13 @@ float VInterpolator::value(float aX) const
     return CalcBezier(GetTForX(aX), mY1, mY2);
 }
 
+void VInterpolator::bake(int frames)
+{
+    mBaked.resize(size_t(frames));
+    for (int i = 0; i < frames; i++)
+        mBaked[size_t(i)] = value(float(i) / float(frames));
+}
+
 float VInterpolator::GetTForX(float aX) const
 {
     // Find interval where t lies
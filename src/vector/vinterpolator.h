@@ -20,6 +20,7 @@
 #define VINTERPOLATOR_H
 
 #include "vpoint.h"
+#include <vector>
 
 V_BEGIN_NAMESPACE
 
@@ -43,6 +44,18 @@ public:
 
     float value(float aX) const;
 
+    /*
+     * Samples value(step / frames) for every step of a keyframe spanning
+     * the given number of frames. As the frame numbers are integers the
+     * lookup gives the same result as value() without solving the curve.
+     */
+    void bake(int frames);
+    int bakedFrames() const { return int(mBaked.size()); }
+    float bakedValue(int step) const { return mBaked[size_t(step)]; }
+
+    VPointF p1() const { return VPointF(mX1, mY1); }
+    VPointF p2() const { return VPointF(mX2, mY2); }
+
     void GetSplineDerivativeValues(float aX, float& aDX, float& aDY) const;
 
 private:
@@ -76,6 +89,7 @@ private:
     float mY2;
     enum { kSplineTableSize = 11 };
     float              mSampleValues[kSplineTableSize];
+    std::vector<float> mBaked;
     static const float kSampleStepSize;
 };
 
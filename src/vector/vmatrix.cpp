@@ -18,9 +18,14 @@
 
 #include "vmatrix.h"
 #include <vglobal.h>
+#include <algorithm>
 #include <cassert>
 #include <cmath>
 
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
 V_BEGIN_NAMESPACE
 
 /*  m11  m21  mtx
@@ -89,6 +94,16 @@ VMatrix &VMatrix::operator/=(float div)
     return operator*=(div);
 }
 
+VMatrix::VMatrix(float h11, float h12, float h13,
+                 float h21, float h22, float h23,
+                 float dx, float dy, float h33)
+    : m11(h11), m12(h12), m13(h13),
+      m21(h21), m22(h22), m23(h23),
+      mtx(dx), mty(dy), m33(h33),
+      dirty(MatrixType::Project)
+{
+}
+
 VMatrix::MatrixType VMatrix::type() const
 {
     if (dirty == MatrixType::None || dirty < mType) return mType;
@@ -553,6 +568,12 @@ bool VMatrix::fuzzyCompare(const VMatrix &o) const
            vCompare(mtx, o.mtx) && vCompare(mty, o.mty);
 }
 
+bool VMatrix::isTranslationOf(const VMatrix &o) const
+{
+    return isAffine() && o.isAffine() && m11 == o.m11 && m12 == o.m12 &&
+           m21 == o.m21 && m22 == o.m22;
+}
+
 #define V_NEAR_CLIP 0.000001f
 #ifdef MAP
 #undef MAP
@@ -695,4 +716,60 @@ VPointF VMatrix::map(const VPointF &p) const
     return {x, y};
 }
 
+static_assert(sizeof(VPointF) == 2 * sizeof(float),
+              "VPointF arrays are mapped as float arrays");
+
+/*
+ * Maps an array of points, dst may be the same array as src. The matrix
+ * type is resolved once for the whole array instead of once per point and
+ * the affine cases map 4 points per iteration with SSE2. The results are
+ * the same as the ones of map(const VPointF &).
+ */
+void VMatrix::map(const VPointF *src, VPointF *dst, size_t count) const
+{
+    VMatrix::MatrixType t = type();
+    if (t == MatrixType::None) {
+        if (src != dst) std::copy(src, src + count, dst);
+        return;
+    }
+    if (t == MatrixType::Project) {
+        for (size_t i = 0; i < count; i++) dst[i] = map(src[i]);
+        return;
+    }
+
+    size_t i = 0;
+#if defined(__SSE2__)
+    const float *in = reinterpret_cast<const float *>(src);
+    float *      out = reinterpret_cast<float *>(dst);
+    // 2 points per register, laid out as x0 y0 x1 y1.
+    const __m128 translate = _mm_setr_ps(mtx, mty, mtx, mty);
+    const __m128 scale = _mm_setr_ps(m11, m22, m11, m22);
+    const __m128 shear = _mm_setr_ps(m21, m12, m21, m12);
+    for (; i + 4 <= count; i += 4) {
+        __m128 p1 = _mm_loadu_ps(in + 2 * i);
+        __m128 p2 = _mm_loadu_ps(in + 2 * i + 4);
+        if (t == MatrixType::Translate) {
+            p1 = _mm_add_ps(p1, translate);
+            p2 = _mm_add_ps(p2, translate);
+        } else if (t == MatrixType::Scale) {
+            p1 = _mm_add_ps(_mm_mul_ps(p1, scale), translate);
+            p2 = _mm_add_ps(_mm_mul_ps(p2, scale), translate);
+        } else {
+            // y0 x0 y1 x1 for the cross terms.
+            __m128 s1 = _mm_shuffle_ps(p1, p1, _MM_SHUFFLE(2, 3, 0, 1));
+            __m128 s2 = _mm_shuffle_ps(p2, p2, _MM_SHUFFLE(2, 3, 0, 1));
+            p1 = _mm_add_ps(
+                _mm_add_ps(_mm_mul_ps(p1, scale), _mm_mul_ps(s1, shear)),
+                translate);
+            p2 = _mm_add_ps(
+                _mm_add_ps(_mm_mul_ps(p2, scale), _mm_mul_ps(s2, shear)),
+                translate);
+        }
+        _mm_storeu_ps(out + 2 * i, p1);
+        _mm_storeu_ps(out + 2 * i + 4, p2);
+    }
+#endif
+    for (; i < count; i++) dst[i] = map(src[i]);
+}
+
 V_END_NAMESPACE
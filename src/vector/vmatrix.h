@@ -37,6 +37,9 @@ public:
         Project = 0x10
     };
     VMatrix() = default;
+    VMatrix(float h11, float h12, float h13,
+            float h21, float h22, float h23,
+            float dx, float dy, float h33);
     bool         isAffine() const;
     bool         isIdentity() const;
     bool         isInvertible() const;
@@ -68,6 +71,7 @@ public:
 
     VPointF        map(const VPointF &p) const;
     inline VPointF map(float x, float y) const;
+    void           map(const VPointF *src, VPointF *dst, size_t count) const;
     VRect          map(const VRect &r) const;
     VRegion        map(const VRegion &r) const;
 
@@ -81,6 +85,8 @@ public:
     bool                 operator==(const VMatrix &) const;
     bool                 operator!=(const VMatrix &) const;
     bool                 fuzzyCompare(const VMatrix &) const;
+    // true when the matrix only differs from o by its translation.
+    bool                 isTranslationOf(const VMatrix &o) const;
     float                scale() const;
 private:
     friend struct VSpanData;
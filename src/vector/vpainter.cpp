@@ -18,6 +18,7 @@
 
 #include "vpainter.h"
 #include <algorithm>
+#include <climits>
 #include "vdrawhelper.h"
 
 V_BEGIN_NAMESPACE
@@ -71,21 +72,21 @@ static void fillRect(const VRect &r, VSpanData *data)
     const int  nspans = 256;
     VRle::Span spans[nspans];
 
-    int y = y1;
-    while (y < y2) {
-        int n = std::min(nspans, y2 - y);
-        int i = 0;
-        while (i < n) {
-            spans[i].x = short(x1);
-            spans[i].len = ushort(x2 - x1);
-            spans[i].y = short(y + i);
-            spans[i].coverage = 255;
-            ++i;
+    // rows wider than a span can hold are split.
+    int n = 0;
+    for (int y = y1; y < y2; y++) {
+        for (int x = x1; x < x2; x += USHRT_MAX) {
+            spans[n].x = x;
+            spans[n].len = ushort(std::min(x2 - x, int(USHRT_MAX)));
+            spans[n].y = y;
+            spans[n].coverage = 255;
+            if (++n == nspans) {
+                data->mUnclippedBlendFunc(n, spans, data);
+                n = 0;
+            }
         }
-
-        data->mUnclippedBlendFunc(n, spans, data);
-        y += n;
     }
+    if (n) data->mUnclippedBlendFunc(n, spans, data);
 }
 
 void VPainterImpl::drawBitmapUntransform(const VRect &  target,
@@ -17,6 +17,7 @@
  */
 
 #include "vpath.h"
+#include <algorithm>
 #include <cassert>
 #include <iterator>
 #include <vector>
@@ -29,9 +30,7 @@ V_BEGIN_NAMESPACE
 
 void VPath::VPathData::transform(const VMatrix &m)
 {
-    for (auto &i : m_points) {
-        i = m.map(i);
-    }
+    m.map(m_points.data(), m_points.data(), m_points.size());
     mLengthDirty = true;
 }
 
@@ -41,6 +40,10 @@ float VPath::VPathData::length() const
 
     mLengthDirty = false;
     mLength = 0.0;
+    mLengths.clear();
+    mLengths.reserve(m_elements.size());
+    mPointCounts.clear();
+    mPointCounts.reserve(m_elements.size());
 
     size_t i = 0;
     for (auto e : m_elements) {
@@ -63,11 +66,40 @@ float VPath::VPathData::length() const
         case VPath::Element::Close:
             break;
         }
+        mLengths.push_back(mLength);
+        mPointCounts.push_back(i);
     }
 
     return mLength;
 }
 
+const std::vector<float> &VPath::VPathData::lengths() const
+{
+    length();
+    return mLengths;
+}
+
+const std::vector<size_t> &VPath::VPathData::pointCounts() const
+{
+    length();
+    return mPointCounts;
+}
+
+VRectF VPath::VPathData::boundingRect() const
+{
+    if (m_points.empty()) return {};
+
+    float minX = m_points[0].x(), maxX = minX;
+    float minY = m_points[0].y(), maxY = minY;
+    for (const auto &pt : m_points) {
+        minX = std::min(minX, pt.x());
+        maxX = std::max(maxX, pt.x());
+        minY = std::min(minY, pt.y());
+        maxY = std::max(maxY, pt.y());
+    }
+    return {minX, minY, maxX - minX, maxY - minY};
+}
+
 void VPath::VPathData::checkNewSegment()
 {
     if (mNewSegment) {
@@ -126,6 +158,8 @@ void VPath::VPathData::reset()
     m_points.clear();
     m_segments = 0;
     mLength = 0;
+    mLengths.clear();
+    mPointCounts.clear();
     mLengthDirty = false;
 }
 
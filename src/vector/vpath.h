@@ -65,6 +65,12 @@ public:
     void addPath(const VPath &path);
     void  transform(const VMatrix &m);
     float length() const;
+    // cumulative length at the end of each element, kept with length().
+    const std::vector<float> &lengths() const;
+    // cumulative point count at the end of each element, kept with lengths().
+    const std::vector<size_t> &pointCounts() const;
+    // bounding rect of all the points including the bezier control points.
+    VRectF boundingRect() const;
     const std::vector<VPath::Element> &elements() const;
     const std::vector<VPointF> &       points() const;
     void  clone(const VPath &srcPath);
@@ -85,6 +91,9 @@ private:
         size_t segments() const;
         void  transform(const VMatrix &m);
         float length() const;
+        const std::vector<float> &lengths() const;
+        const std::vector<size_t> &pointCounts() const;
+        VRectF boundingRect() const;
         void  addRoundRect(const VRectF &, float, float, VPath::Direction);
         void  addRoundRect(const VRectF &, float, VPath::Direction);
         void  addRect(const VRectF &, VPath::Direction);
@@ -110,6 +119,8 @@ private:
         size_t                      m_segments;
         VPointF                     mStartPoint;
         mutable float               mLength{0};
+        mutable std::vector<float>  mLengths;
+        mutable std::vector<size_t> mPointCounts;
         mutable bool                mLengthDirty{true};
         bool                        mNewSegment;
     };
@@ -165,6 +176,21 @@ inline float VPath::length() const
     return d->length();
 }
 
+inline const std::vector<float> &VPath::lengths() const
+{
+    return d->lengths();
+}
+
+inline const std::vector<size_t> &VPath::pointCounts() const
+{
+    return d->pointCounts();
+}
+
+inline VRectF VPath::boundingRect() const
+{
+    return d->boundingRect();
+}
+
 inline void VPath::cubicTo(const VPointF &c1, const VPointF &c2,
                            const VPointF &e)
 {
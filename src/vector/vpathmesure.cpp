@@ -17,9 +17,11 @@
  */
 
 #include "vpathmesure.h"
+#include <algorithm>
 #include <limits>
 #include "vbezier.h"
 #include "vdasher.h"
+#include "vline.h"
 
 V_BEGIN_NAMESPACE
 
@@ -29,6 +31,78 @@ V_BEGIN_NAMESPACE
  * if start > end it treates as a loop and trims as two segment
  *  [0-->end] and [start --> 1]
  */
+/*
+ * Appends the part of a single contour path between the lengths from and
+ * to. The first element of the range is found with a binary search on the
+ * cached cumulative lengths of the path and its first point is read from
+ * the point counts cached next to them, only the elements at both ends of
+ * the range are split and the ones in between are copied as they are.
+ */
+static void addRange(const VPath &path, float from, float to, VPath &result)
+{
+    if (to <= from) return;
+
+    const std::vector<VPath::Element> &elms = path.elements();
+    const std::vector<VPointF> &       pts = path.points();
+    const std::vector<float> &         lengths = path.lengths();
+
+    size_t first = size_t(
+        std::upper_bound(lengths.cbegin(), lengths.cend(), from) -
+        lengths.cbegin());
+
+    size_t pt = first ? path.pointCounts()[first - 1] : 0;
+
+    bool started = false;
+    for (size_t i = first; i < elms.size(); i++) {
+        float begin = i ? lengths[i - 1] : 0;
+        if (begin >= to) break;
+
+        float end = lengths[i];
+        switch (elms[i]) {
+        case VPath::Element::LineTo: {
+            VLine line(pts[pt - 1], pts[pt]);
+            VLine left, right;
+            if (from > begin) {
+                line.splitAtLength(from - begin, left, right);
+                line = right;
+            }
+            if (to < end) {
+                line.splitAtLength(to - std::max(from, begin), left, right);
+                line = left;
+            }
+            if (!started) result.moveTo(line.p1());
+            result.lineTo(line.p2());
+            started = true;
+            pt++;
+            break;
+        }
+        case VPath::Element::CubicTo: {
+            VBezier b = VBezier::fromPoints(pts[pt - 1], pts[pt], pts[pt + 1],
+                                            pts[pt + 2]);
+            VBezier left, right;
+            if (from > begin) {
+                b.splitAtLength(from - begin, &left, &right);
+                b = right;
+            }
+            if (to < end) {
+                b.splitAtLength(to - std::max(from, begin), &left, &right);
+                b = left;
+            }
+            if (!started) result.moveTo(b.pt1());
+            result.cubicTo(b.pt2(), b.pt3(), b.pt4());
+            started = true;
+            pt += 3;
+            break;
+        }
+        case VPath::Element::MoveTo:
+            pt++;
+            break;
+        case VPath::Element::Close:
+            break;
+        }
+    }
+}
+
 VPath VPathMesure::trim(const VPath &path)
 {
     if (vCompare(mStart, mEnd)) return VPath();
@@ -39,6 +113,22 @@ VPath VPathMesure::trim(const VPath &path)
 
     float length = path.length();
 
+    // the dash pattern restarts at every contour, keep that behaviour for
+    // the paths having more than one.
+    if (path.segments() != 1) return dash(path, length);
+
+    mScratchObject.reset();
+    if (mStart < mEnd) {
+        addRange(path, length * mStart, length * mEnd, mScratchObject);
+    } else {
+        addRange(path, 0, length * mEnd, mScratchObject);
+        addRange(path, length * mStart, length, mScratchObject);
+    }
+    return mScratchObject;
+}
+
+VPath VPathMesure::dash(const VPath &path, float length)
+{
     if (mStart < mEnd) {
         float array[4] = {
             0.0f, length * mStart,  // 1st segment
@@ -30,6 +30,7 @@ public:
     void  setEnd(float end){mEnd = end;}
     VPath trim(const VPath &path);
 private:
+    VPath dash(const VPath &path, float length);
     float mStart{0.0f};
     float mEnd{1.0f};
     VPath mScratchObject;
@@ -0,0 +1,171 @@
+/*
+ * Copyright (c) 2018 Samsung Electronics Co., Ltd. All rights reserved.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA
+ */
+
+#include "vpolylinestroker.h"
+#include <algorithm>
+#include <cmath>
+
+V_BEGIN_NAMESPACE
+
+bool VPolylineStroker::stroke(const VPath &path, const VMatrix &m,
+                              CapStyle cap, JoinStyle join, float width,
+                              float miterLimit)
+{
+    if (cap != CapStyle::Flat ||
+        (join != JoinStyle::Miter && join != JoinStyle::Bevel))
+        return false;
+
+    auto same = [](const VPointF &p1, const VPointF &p2) {
+        return p1.x() == p2.x() && p1.y() == p2.y();
+    };
+    const auto &elements = path.elements();
+    const auto &points = path.points();
+    for (size_t i = 0, index = 0; i < elements.size(); i++) {
+        if (elements[i] == VPath::Element::CubicTo) {
+            if (!same(points[index], points[index - 1]) ||
+                !same(points[index + 1], points[index + 2]))
+                return false;
+            index += 3;
+        } else if (elements[i] != VPath::Element::Close) {
+            index++;
+        }
+    }
+
+    mRadius = width / 2.0f;
+    mMiterLimit = std::max(miterLimit, 1.0f);
+    mMiter = join == JoinStyle::Miter;
+    mOutline.clear();
+    mContours.clear();
+    mPts.clear();
+    mSegments.clear();
+
+    size_t index = 0;
+    for (auto element : elements) {
+        switch (element) {
+        case VPath::Element::MoveTo:
+            endSubPath(false);
+            mPts.push_back(m.map(points[index]));
+            index++;
+            break;
+        case VPath::Element::LineTo:
+            addPoint(m.map(points[index]), true);
+            index++;
+            break;
+        case VPath::Element::CubicTo:
+            addPoint(m.map(points[index + 2]), false);
+            index += 3;
+            break;
+        case VPath::Element::Close:
+            if (!mPts.empty()) addPoint(mPts.front(), true);
+            endSubPath(true);
+            break;
+        }
+    }
+    endSubPath(false);
+
+    return true;
+}
+
+void VPolylineStroker::addPoint(const VPointF &pt, bool line)
+{
+    if (mPts.empty()) return;
+
+    // segments that vanish in the 26.6 outline are dropped like the
+    // freetype stroker does.
+    VPointF delta = pt - mPts.back();
+    float   length = std::sqrt(delta.x() * delta.x() + delta.y() * delta.y());
+    if (length < 1.0f / 64) return;
+
+    Segment segment;
+    segment.dir = delta / length;
+    segment.normal = VPointF(-segment.dir.y(), segment.dir.x()) * mRadius;
+    segment.length = length;
+    segment.line = line;
+    mSegments.push_back(segment);
+    mPts.push_back(pt);
+}
+
+void VPolylineStroker::endSubPath(bool closed)
+{
+    // an open subpath is a single contour closed by the butt caps, a
+    // closed one has an outer and an inner contour.
+    if (!mSegments.empty()) {
+        addBorder(1, closed);
+        if (closed) mContours.push_back(mOutline.size());
+        addBorder(-1, closed);
+        mContours.push_back(mOutline.size());
+    }
+    mPts.clear();
+    mSegments.clear();
+}
+
+/*
+ * appends the border on one side of the subpath, the right border
+ * (side -1) is reversed so that it continues the left one.
+ */
+void VPolylineStroker::addBorder(float side, bool closed)
+{
+    size_t count = mSegments.size();
+
+    mBorder.clear();
+    if (closed) {
+        for (size_t i = 0; i < count; i++)
+            addJoin((i + count - 1) % count, i, side);
+    } else {
+        mBorder.push_back(mPts.front() + mSegments.front().normal * side);
+        for (size_t i = 1; i < count; i++) addJoin(i - 1, i, side);
+        mBorder.push_back(mPts.back() + mSegments.back().normal * side);
+    }
+
+    if (side > 0)
+        mOutline.insert(mOutline.end(), mBorder.begin(), mBorder.end());
+    else
+        mOutline.insert(mOutline.end(), mBorder.rbegin(), mBorder.rend());
+}
+
+void VPolylineStroker::addJoin(size_t in, size_t out, float side)
+{
+    const Segment &a = mSegments[in];
+    const Segment &b = mSegments[out];
+    const VPointF &center = mPts[out];
+    VPointF        na = a.normal * side;
+    VPointF        nb = b.normal * side;
+    float          cross = a.dir.x() * b.dir.y() - a.dir.y() * b.dir.x();
+    float          dot = a.dir.x() * b.dir.x() + a.dir.y() * b.dir.y();
+
+    if (side * cross > 0) {
+        // inner corner, tan of the half angle is cross / (1 + dot).
+        float minLength = mRadius * cross * side / (1 + dot);
+        if (a.line && b.line && a.length >= minLength &&
+            b.length >= minLength) {
+            mBorder.push_back(center + (na + nb) / (1 + dot));
+        } else {
+            mBorder.push_back(center + na);
+            mBorder.push_back(center + nb);
+        }
+        return;
+    }
+
+    mBorder.push_back(center + na);
+    // the miter length is radius / cos of the half angle.
+    if (mMiter && mMiterLimit * std::sqrt((1 + dot) / 2) >= 1)
+        mBorder.push_back(center + (na + nb) / (1 + dot));
+    mBorder.push_back(center + nb);
+}
+
+V_END_NAMESPACE
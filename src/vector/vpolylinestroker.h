@@ -0,0 +1,70 @@
+/*
+ * Copyright (c) 2018 Samsung Electronics Co., Ltd. All rights reserved.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA
+ */
+
+#ifndef VPOLYLINESTROKER_H
+#define VPOLYLINESTROKER_H
+
+#include <vector>
+#include "vglobal.h"
+#include "vmatrix.h"
+#include "vpath.h"
+
+V_BEGIN_NAMESPACE
+
+/*
+ * float stroker for the common case of polylines with miter or bevel
+ * joins and butt caps. It follows the construction of the freetype
+ * stroker: the left border of a subpath is walked forward and the right
+ * one backward, outer corners get a miter or a bevel and inner corners
+ * of two long enough lines meet at the intersection of the borders.
+ * Cubics are only accepted when their control points sit on the end
+ * points, which is how lottie stores straight lines. Everything else is
+ * left to the freetype stroker.
+ */
+class VPolylineStroker {
+public:
+    bool stroke(const VPath &path, const VMatrix &m, CapStyle cap,
+                JoinStyle join, float width, float miterLimit);
+    const std::vector<VPointF> &points() const { return mOutline; }
+    const std::vector<size_t> & contours() const { return mContours; }
+
+private:
+    struct Segment {
+        VPointF dir;
+        VPointF normal;
+        float   length;
+        bool    line;
+    };
+    void addPoint(const VPointF &pt, bool line);
+    void endSubPath(bool closed);
+    void addBorder(float side, bool closed);
+    void addJoin(size_t in, size_t out, float side);
+
+    std::vector<VPointF> mPts;
+    std::vector<Segment> mSegments;
+    std::vector<VPointF> mBorder;
+    std::vector<VPointF> mOutline;
+    std::vector<size_t>  mContours;
+    float                mRadius{0};
+    float                mMiterLimit{1};
+    bool                 mMiter{false};
+};
+
+V_END_NAMESPACE
+
+#endif  // VPOLYLINESTROKER_H
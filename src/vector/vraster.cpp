@@ -17,7 +17,9 @@
  */
 
 #include "vraster.h"
+#include <algorithm>
 #include <climits>
+#include <cstddef>
 #include <cstring>
 #include <memory>
 #include "config.h"
@@ -26,6 +28,8 @@
 #include "vdebug.h"
 #include "vmatrix.h"
 #include "vpath.h"
+#include "vpolylinestroker.h"
+#include "vrectrle.h"
 #include "vrle.h"
 
 V_BEGIN_NAMESPACE
@@ -55,14 +59,14 @@ struct FTOutline {
 public:
     void reset();
     void grow(size_t, size_t);
-    void convert(const VPath &path);
+    void convert(const VPath &path, const VMatrix &m);
     void convert(CapStyle, JoinStyle, float, float);
+    void convert(const VPolylineStroker &stroker);
     void moveTo(const VPointF &pt);
     void lineTo(const VPointF &pt);
     void cubicTo(const VPointF &ctr1, const VPointF &ctr2, const VPointF end);
     void close();
     void end();
-    void transform(const VMatrix &m);
     SW_FT_Pos TO_FT_COORD(float x)
     {
         return SW_FT_Pos(x * 64);
@@ -75,8 +79,10 @@ public:
     SW_FT_Fixed             ftMiterLimit;
     dyn_array<SW_FT_Vector> mPointMemory{100};
     dyn_array<char>         mTagMemory{100};
-    dyn_array<short>        mContourMemory{10};
+    dyn_array<int>          mContourMemory{10};
     dyn_array<char>         mContourFlagMemory{10};
+    dyn_array<VPointF>      mMappedMemory{100};
+    VPolylineStroker        mPolylineStroker;
 };
 
 void FTOutline::reset()
@@ -99,12 +105,23 @@ void FTOutline::grow(size_t points, size_t segments)
     ft.contours_flag = mContourFlagMemory.data();
 }
 
-void FTOutline::convert(const VPath &path)
+/*
+ * the points are mapped by m with the batched VMatrix::map() before they
+ * are converted, so a path in local co-ordinates doesn't need a
+ * transformed copy before rasterization.
+ */
+void FTOutline::convert(const VPath &path, const VMatrix &m)
 {
     const std::vector<VPath::Element> &elements = path.elements();
-    const std::vector<VPointF> &       points = path.points();
+    const VPointF *                    points = path.points().data();
 
-    grow(points.size(), path.segments());
+    grow(path.points().size(), path.segments());
+
+    if (!m.isIdentity()) {
+        mMappedMemory.reserve(path.points().size());
+        m.map(points, mMappedMemory.data(), path.points().size());
+        points = mMappedMemory.data();
+    }
 
     size_t index = 0;
     for (auto element : elements) {
@@ -166,10 +183,28 @@ void FTOutline::convert(CapStyle cap, JoinStyle join, float width,
     }
 }
 
-void FTOutline::moveTo(const VPointF &pt)
+void FTOutline::convert(const VPolylineStroker &stroker)
 {
-    assert(ft.n_points <= SHRT_MAX - 1);
+    const auto &points = stroker.points();
+    const auto &contours = stroker.contours();
 
+    grow(points.size(), contours.size());
+
+    for (const auto &pt : points) {
+        ft.points[ft.n_points].x = TO_FT_COORD(pt.x());
+        ft.points[ft.n_points].y = TO_FT_COORD(pt.y());
+        ft.tags[ft.n_points] = SW_FT_CURVE_TAG_ON;
+        ft.n_points++;
+    }
+    for (auto end : contours) {
+        ft.contours[ft.n_contours] = int(end - 1);
+        ft.contours_flag[ft.n_contours] = 0;
+        ft.n_contours++;
+    }
+}
+
+void FTOutline::moveTo(const VPointF &pt)
+{
     ft.points[ft.n_points].x = TO_FT_COORD(pt.x());
     ft.points[ft.n_points].y = TO_FT_COORD(pt.y());
     ft.tags[ft.n_points] = SW_FT_CURVE_TAG_ON;
@@ -186,8 +221,6 @@ void FTOutline::moveTo(const VPointF &pt)
 
 void FTOutline::lineTo(const VPointF &pt)
 {
-    assert(ft.n_points <= SHRT_MAX - 1);
-
     ft.points[ft.n_points].x = TO_FT_COORD(pt.x());
     ft.points[ft.n_points].y = TO_FT_COORD(pt.y());
     ft.tags[ft.n_points] = SW_FT_CURVE_TAG_ON;
@@ -197,8 +230,6 @@ void FTOutline::lineTo(const VPointF &pt)
 void FTOutline::cubicTo(const VPointF &cp1, const VPointF &cp2,
                         const VPointF ep)
 {
-    assert(ft.n_points <= SHRT_MAX - 3);
-
     ft.points[ft.n_points].x = TO_FT_COORD(cp1.x());
     ft.points[ft.n_points].y = TO_FT_COORD(cp1.y());
     ft.tags[ft.n_points] = SW_FT_CURVE_TAG_CUBIC;
@@ -216,8 +247,6 @@ void FTOutline::cubicTo(const VPointF &cp1, const VPointF &cp2,
 }
 void FTOutline::close()
 {
-    assert(ft.n_points <= SHRT_MAX - 1);
-
     // mark the contour as a close path.
     ft.contours_flag[ft.n_contours] = 0;
 
@@ -242,14 +271,16 @@ void FTOutline::close()
 
 void FTOutline::end()
 {
-    assert(ft.n_contours <= SHRT_MAX - 1);
-
     if (ft.n_points) {
         ft.contours[ft.n_contours] = ft.n_points - 1;
         ft.n_contours++;
     }
 }
 
+static_assert(sizeof(VRle::Span) == sizeof(SW_FT_Span) &&
+                  offsetof(VRle::Span, len) == offsetof(SW_FT_Span, len),
+              "raster spans are passed to the rle without conversion");
+
 static void rleGenerationCb(int count, const SW_FT_Span *spans, void *user)
 {
     VRle *rle = static_cast<VRle *>(user);
@@ -302,6 +333,7 @@ private:
 struct VRleTask {
     SharedRle mRle;
     VPath     mPath;
+    VMatrix   mMatrix;
     float     mStrokeWidth;
     float     mMiterLimit;
     VRect     mClip;
@@ -312,20 +344,23 @@ struct VRleTask {
 
     VRle &rle() { return mRle.get(); }
 
-    void update(VPath path, FillRule fillRule, const VRect &clip)
+    void update(VPath path, const VMatrix &m, FillRule fillRule,
+                const VRect &clip)
     {
         mRle.reset();
         mPath = std::move(path);
+        mMatrix = m;
         mFillRule = fillRule;
         mClip = clip;
         mGenerateStroke = false;
     }
 
-    void update(VPath path, CapStyle cap, JoinStyle join, float width,
-                float miterLimit, const VRect &clip)
+    void update(VPath path, const VMatrix &m, CapStyle cap, JoinStyle join,
+                float width, float miterLimit, const VRect &clip)
     {
         mRle.reset();
         mPath = std::move(path);
+        mMatrix = m;
         mCap = cap;
         mJoin = join;
         mStrokeWidth = width;
@@ -359,13 +394,12 @@ struct VRleTask {
 
     void operator()(FTOutline &outRef, SW_FT_Stroker &stroker)
     {
-        if (mPath.points().size() > SHRT_MAX ||
-            mPath.points().size() + mPath.segments() > SHRT_MAX) {
-            return;
-        }
-
-        if (mGenerateStroke) {  // Stroke Task
-            outRef.convert(mPath);
+        if (mGenerateStroke &&
+            outRef.mPolylineStroker.stroke(mPath, mMatrix, mCap, mJoin,
+                                           mStrokeWidth, mMiterLimit)) {
+            outRef.convert(outRef.mPolylineStroker);
+        } else if (mGenerateStroke) {  // Stroke Task
+            outRef.convert(mPath, mMatrix);
             outRef.convert(mCap, mJoin, mStrokeWidth, mMiterLimit);
 
             uint points, contors;
@@ -380,7 +414,7 @@ struct VRleTask {
             SW_FT_Stroker_Export(stroker, &outRef.ft);
 
         } else {  // Fill Task
-            outRef.convert(mPath);
+            outRef.convert(mPath, mMatrix);
             int fillRuleFlag = SW_FT_OUTLINE_NONE;
             switch (mFillRule) {
             case FillRule::EvenOdd:
@@ -514,6 +548,21 @@ VRle VRasterizer::rle()
     return d->rle();
 }
 
+void VRasterizer::translate(const VPoint &offset)
+{
+    if (!d) return;
+    d->rle().translate(offset);
+}
+
+size_t VRasterizer::release()
+{
+    if (!d) return 0;
+
+    size_t bytes = d->rle().memorySize();
+    d = nullptr;
+    return bytes;
+}
+
 void VRasterizer::init()
 {
     if (!d) d = std::make_shared<VRasterizerImpl>();
@@ -526,25 +575,39 @@ void VRasterizer::updateRequest()
 }
 
 void VRasterizer::rasterize(VPath path, FillRule fillRule, const VRect &clip)
+{
+    rasterize(std::move(path), VMatrix(), fillRule, clip);
+}
+
+void VRasterizer::rasterize(VPath path, const VMatrix &m, FillRule fillRule,
+                            const VRect &clip)
 {
     init();
     if (path.empty()) {
         d->rle().reset();
         return;
     }
-    d->task().update(std::move(path), fillRule, clip);
+    if (rectRle(path, m, clip, d->rle())) return;
+    d->task().update(std::move(path), m, fillRule, clip);
     updateRequest();
 }
 
 void VRasterizer::rasterize(VPath path, CapStyle cap, JoinStyle join,
                             float width, float miterLimit, const VRect &clip)
+{
+    rasterize(std::move(path), VMatrix(), cap, join, width, miterLimit, clip);
+}
+
+void VRasterizer::rasterize(VPath path, const VMatrix &m, CapStyle cap,
+                            JoinStyle join, float width, float miterLimit,
+                            const VRect &clip)
 {
     init();
     if (path.empty() || vIsZero(width)) {
         d->rle().reset();
         return;
     }
-    d->task().update(std::move(path), cap, join, width, miterLimit, clip);
+    d->task().update(std::move(path), m, cap, join, width, miterLimit, clip);
     updateRequest();
 }
 
@@ -26,6 +26,7 @@ V_BEGIN_NAMESPACE
 
 class VPath;
 class VRle;
+class VMatrix;
 
 class VRasterizer
 {
@@ -33,7 +34,23 @@ public:
     void rasterize(VPath path, FillRule fillRule = FillRule::Winding, const VRect &clip = VRect());
     void rasterize(VPath path, CapStyle cap, JoinStyle join, float width,
                    float miterLimit, const VRect &clip = VRect());
+    /*
+     * rasterizes the path mapped by m, the points are transformed while
+     * they are converted to the raster outline. The stroke width is in
+     * the mapped co-ordinates.
+     */
+    void rasterize(VPath path, const VMatrix &m,
+                   FillRule fillRule = FillRule::Winding,
+                   const VRect &clip = VRect());
+    void rasterize(VPath path, const VMatrix &m, CapStyle cap, JoinStyle join,
+                   float width, float miterLimit, const VRect &clip = VRect());
     VRle rle();
+    /* moves the generated rle by offset instead of rasterizing again. */
+    void translate(const VPoint &offset);
+    /* false before the first rasterize() and after release(). */
+    bool hasRle() const { return d != nullptr; }
+    /* drops the rle data, returns the number of bytes freed. */
+    size_t release();
 private:
     struct VRasterizerImpl;
     void init();
@@ -18,6 +18,7 @@
 
 #ifndef VRECT_H
 #define VRECT_H
+#include <cmath>
 #include "vglobal.h"
 #include "vpoint.h"
 
@@ -150,6 +151,18 @@ public:
         x2 += dx;
         y2 += dy;
     }
+    // smallest integer rect that contains this rect, clamped so that
+    // far away coordinates don't overflow.
+    VRect toAlignedRect() const
+    {
+        auto clamp = [](float v) {
+            const float limit = 1 << 28;
+            return int(v < -limit ? -limit : (v > limit ? limit : v));
+        };
+        int l = clamp(std::floor(x1));
+        int t = clamp(std::floor(y1));
+        return {l, t, clamp(std::ceil(x2)) - l, clamp(std::ceil(y2)) - t};
+    }
 
 private:
     float x1{0};
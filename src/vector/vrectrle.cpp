@@ -0,0 +1,149 @@
+/*
+ * Copyright (c) 2018 Samsung Electronics Co., Ltd. All rights reserved.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA
+ */
+
+#include "vrectrle.h"
+#include <algorithm>
+#include <climits>
+#include <vector>
+#include "v_ft_raster.h"
+
+V_BEGIN_NAMESPACE
+
+/*
+ * checks if the path is a single axis aligned rectangle, like the ones
+ * VPath::addRect() creates once they are scaled and translated.
+ */
+static bool axisAlignedRect(const VPath &path)
+{
+    const auto &elms = path.elements();
+    const auto &pts = path.points();
+
+    if (pts.size() != 4 && pts.size() != 5) return false;
+    if (elms.size() != pts.size() + (elms.back() == VPath::Element::Close))
+        return false;
+    if (elms[0] != VPath::Element::MoveTo) return false;
+    for (size_t i = 1; i < pts.size(); i++)
+        if (elms[i] != VPath::Element::LineTo) return false;
+    if (pts.size() == 5 &&
+        (pts[4].x() != pts[0].x() || pts[4].y() != pts[0].y()))
+        return false;
+
+    bool horizontal = pts[0].y() == pts[1].y() && pts[1].x() == pts[2].x() &&
+                      pts[2].y() == pts[3].y() && pts[3].x() == pts[0].x();
+    bool vertical = pts[0].x() == pts[1].x() && pts[1].y() == pts[2].y() &&
+                    pts[2].x() == pts[3].x() && pts[3].y() == pts[0].y();
+    return horizontal || vertical;
+}
+
+bool rectRle(const VPath &path, const VMatrix &m, const VRect &clip, VRle &rle)
+{
+    // scaling and translation keep the rectangle axis aligned.
+    if (m.type() > VMatrix::MatrixType::Scale || !axisAlignedRect(path))
+        return false;
+
+    const auto &pts = path.points();
+    VPointF     p0 = m.map(pts[0]), p1 = m.map(pts[1]), p2 = m.map(pts[2]);
+    float       left = std::min(p0.x(), p2.x());
+    float       right = std::max(p0.x(), p2.x());
+    float       top = std::min(p0.y(), p2.y());
+    float       bottom = std::max(p0.y(), p2.y());
+    if (!clip.empty()) {
+        left = std::max(left, float(clip.left()));
+        right = std::min(right, float(clip.right()));
+        top = std::max(top, float(clip.top()));
+        bottom = std::min(bottom, float(clip.bottom()));
+    }
+
+    // keep the sub pixel positions inside the range of the raster.
+    const float limit = float(INT_MAX >> 8);
+    if (left < -limit || right > limit || top < -limit || bottom > limit)
+        return false;
+
+    rle.reset();
+    if (left >= right || top >= bottom) return true;
+
+    // same conversion as FTOutline, 26.6 then upscaled to 24.8.
+    auto subPixel = [](float v) { return long(SW_FT_Pos(v * 64)) * 4; };
+    long x1 = subPixel(left), x2 = subPixel(right);
+    long y1 = subPixel(top), y2 = subPixel(bottom);
+    if (x1 >= x2 || y1 >= y2) return true;
+
+    // the winding of the outline decides the rounding of the coverage,
+    // in the raster a negative area is rounded away from zero.
+    float cross = (p1.x() - p0.x()) * (p2.y() - p1.y()) -
+                  (p1.y() - p0.y()) * (p2.x() - p1.x());
+    bool roundUp = cross > 0;
+
+    auto overlap = [](long lo, long hi, long cell) {
+        return std::min(hi, (cell + 1) << 8) - std::max(lo, cell << 8);
+    };
+    auto coverage = [roundUp](long area) {
+        long c = roundUp ? (area + 255) >> 8 : area >> 8;
+        return uchar(std::min(c, 255L));
+    };
+
+    long firstX = x1 >> 8, lastX = (x2 - 1) >> 8;
+    long firstY = y1 >> 8, lastY = (y2 - 1) >> 8;
+
+    std::vector<VRle::Span> spans;
+    spans.reserve(size_t(lastY - firstY + 1) * 3);
+    // adds a span, merging it with the previous one like the raster does.
+    auto addSpan = [&spans](long x, long y, long len, uchar cov) {
+        if (!cov) return;
+        while (len > 0) {
+            long piece = std::min(len, long(USHRT_MAX));
+            if (!spans.empty() && spans.back().y == y &&
+                spans.back().x + spans.back().len == x &&
+                spans.back().coverage == cov &&
+                spans.back().len + piece <= USHRT_MAX) {
+                spans.back().len = ushort(spans.back().len + piece);
+            } else {
+                VRle::Span span;
+                span.x = int(x);
+                span.y = int(y);
+                span.len = ushort(piece);
+                span.coverage = cov;
+                spans.push_back(span);
+            }
+            x += piece;
+            len -= piece;
+        }
+    };
+
+    for (long y = firstY; y <= lastY; y++) {
+        long oy = overlap(y1, y2, y);
+        addSpan(firstX, y, 1, coverage(overlap(x1, x2, firstX) * oy));
+        if (firstX == lastX) continue;
+        // all the inner pixels of a row are fully covered horizontally.
+        addSpan(firstX + 1, y, lastX - firstX - 1, coverage(256 * oy));
+        addSpan(lastX, y, 1, coverage(overlap(x1, x2, lastX) * oy));
+    }
+    if (spans.empty()) return true;
+
+    rle.addSpan(spans.data(), spans.size());
+    int minX = INT_MAX, maxX = INT_MIN;
+    for (const auto &span : spans) {
+        minX = std::min(minX, int(span.x));
+        maxX = std::max(maxX, span.x + span.len);
+    }
+    rle.setBoundingRect({minX, spans.front().y, maxX - minX,
+                         spans.back().y - spans.front().y + 1});
+    return true;
+}
+
+V_END_NAMESPACE
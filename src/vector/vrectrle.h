@@ -0,0 +1,41 @@
+/*
+ * Copyright (c) 2018 Samsung Electronics Co., Ltd. All rights reserved.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA
+ */
+
+#ifndef VRECTRLE_H
+#define VRECTRLE_H
+
+#include "vglobal.h"
+#include "vmatrix.h"
+#include "vpath.h"
+#include "vrect.h"
+#include "vrle.h"
+
+V_BEGIN_NAMESPACE
+
+/*
+ * generates the rle of an axis aligned rectangle without going through
+ * the scanline converter. The coverage is computed in the same 24.8 fixed
+ * point and with the same rounding as the gray raster, so the result is
+ * identical to rasterizing the rectangle path. Returns false when the
+ * path mapped by m is not such a rectangle.
+ */
+bool rectRle(const VPath &path, const VMatrix &m, const VRect &clip, VRle &rle);
+
+V_END_NAMESPACE
+
+#endif  // VRECTRLE_H
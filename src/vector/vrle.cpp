@@ -20,7 +20,9 @@
 #include <vrect.h>
 #include <algorithm>
 #include <array>
+#include <climits>
 #include <cstdlib>
+#include <limits>
 #include <vector>
 #include "vdebug.h"
 #include "vglobal.h"
@@ -38,9 +40,10 @@ struct VRleHelper {
 static void rleIntersectWithRle(VRleHelper *, int, int, VRleHelper *,
                                 VRleHelper *);
 static void rleIntersectWithRect(const VRect &, VRleHelper *, VRleHelper *);
-static void rleOpGeneric(VRleHelper *, VRleHelper *, VRleHelper *,
-                         Operation op);
-static void rleSubstractWithRle(VRleHelper *, VRleHelper *, VRleHelper *);
+static void rleOpGeneric(VRleHelper *, VRleHelper *,
+                         std::vector<VRle::Span> &, Operation op);
+static void rleSubstractWithRle(VRleHelper *, VRleHelper *,
+                                std::vector<VRle::Span> &);
 
 static inline uchar divBy255(int x)
 {
@@ -55,6 +58,25 @@ inline static void copyArrayToVector(const VRle::Span *span, size_t count,
     std::copy(span, span + count, back_inserter(v));
 }
 
+/*
+ * appends a run of pixels with the same coverage, runs longer than a
+ * span can hold are split.
+ */
+static void addRowSpan(std::vector<VRle::Span> &out, int x, int y, int len,
+                       uchar coverage)
+{
+    VRle::Span span;
+    span.y = y;
+    span.coverage = coverage;
+    while (len > 0) {
+        span.x = x;
+        span.len = ushort(std::min(len, int(USHRT_MAX)));
+        out.push_back(span);
+        x += span.len;
+        len -= span.len;
+    }
+}
+
 void VRle::VRleData::addSpan(const VRle::Span *span, size_t count)
 {
     copyArrayToVector(span, count, mSpans);
@@ -77,7 +99,6 @@ void VRle::VRleData::reset()
 {
     mSpans.clear();
     mBbox = VRect();
-    mOffset = VPoint();
     mBboxDirty = false;
 }
 
@@ -88,16 +109,15 @@ void VRle::VRleData::clone(const VRle::VRleData &o)
 
 void VRle::VRleData::translate(const VPoint &p)
 {
-    // take care of last offset if applied
-    mOffset = p - mOffset;
-    int x = mOffset.x();
-    int y = mOffset.y();
+    int x = p.x();
+    int y = p.y();
+    // bbox has to be computed before the spans are moved.
+    updateBbox();
     for (auto &i : mSpans) {
         i.x = i.x + x;
         i.y = i.y + y;
     }
-    updateBbox();
-    mBbox.translate(mOffset.x(), mOffset.y());
+    mBbox.translate(x, y);
 }
 
 void VRle::VRleData::addRect(const VRect &rect)
@@ -109,14 +129,7 @@ void VRle::VRleData::addRect(const VRect &rect)
 
     mSpans.reserve(size_t(height));
 
-    VRle::Span span;
-    for (int i = 0; i < height; i++) {
-        span.x = x;
-        span.y = y + i;
-        span.len = width;
-        span.coverage = 255;
-        mSpans.push_back(span);
-    }
+    for (int i = 0; i < height; i++) addRowSpan(mSpans, x, y + i, width, 255);
     updateBbox();
 }
 
@@ -213,13 +226,7 @@ void VRle::VRleData::opSubstract(const VRle::VRleData &a,
         size_t sizeB = size_t(bPtr - b.mSpans.data());
 
         // 2. calculate the intersect region
-        VRleHelper                  tresult, aObj, bObj;
-        std::array<VRle::Span, 256> array;
-
-        // setup the tresult object
-        tresult.size = array.size();
-        tresult.alloc = array.size();
-        tresult.spans = array.data();
+        VRleHelper aObj, bObj;
 
         // setup a object
         aObj.size = a.mSpans.size() - sizeA;
@@ -229,14 +236,7 @@ void VRle::VRleData::opSubstract(const VRle::VRleData &a,
         bObj.size = b.mSpans.size() - sizeB;
         bObj.spans = bPtr;
 
-        // run till all the spans are processed
-        while (aObj.size && bObj.size) {
-            rleSubstractWithRle(&aObj, &bObj, &tresult);
-            if (tresult.size) {
-                copyArrayToVector(tresult.spans, tresult.size, mSpans);
-            }
-            tresult.size = 0;
-        }
+        rleSubstractWithRle(&aObj, &bObj, mSpans);
         // 3. copy the rest of a
         if (aObj.size) copyArrayToVector(aObj.spans, aObj.size, mSpans);
     }
@@ -278,13 +278,7 @@ void VRle::VRleData::opGeneric(const VRle::VRleData &a, const VRle::VRleData &b,
         if (sizeB) copyArrayToVector(b.mSpans.data(), sizeB, mSpans);
 
         // 3. calculate the intersect region
-        VRleHelper                  tresult, aObj, bObj;
-        std::array<VRle::Span, 256> array;
-
-        // setup the tresult object
-        tresult.size = array.size();
-        tresult.alloc = array.size();
-        tresult.spans = array.data();
+        VRleHelper aObj, bObj;
 
         // setup a object
         aObj.size = a.mSpans.size() - sizeA;
@@ -303,14 +297,7 @@ void VRle::VRleData::opGeneric(const VRle::VRleData &a, const VRle::VRleData &b,
             op = Operation::Xor;
             break;
         }
-        // run till all the spans are processed
-        while (aObj.size && bObj.size) {
-            rleOpGeneric(&aObj, &bObj, &tresult, op);
-            if (tresult.size) {
-                copyArrayToVector(tresult.spans, tresult.size, mSpans);
-            }
-            tresult.size = 0;
-        }
+        rleOpGeneric(&aObj, &bObj, mSpans, op);
         // 3. copy the rest
         if (bObj.size) copyArrayToVector(bObj.spans, bObj.size, mSpans);
         if (aObj.size) copyArrayToVector(aObj.spans, aObj.size, mSpans);
@@ -461,7 +448,7 @@ static void rleIntersectWithRect(const VRect &clip, VRleHelper *tmp_obj,
     size_t      available = result->alloc;
     VRle::Span *spans = tmp_obj->spans;
     VRle::Span *end = tmp_obj->spans + tmp_obj->size;
-    short       minx, miny, maxx, maxy;
+    int         minx, miny, maxx, maxy;
 
     minx = clip.left();
     miny = clip.top();
@@ -561,57 +548,41 @@ void blit(VRle::Span *spans, int count, uchar *buffer, int offsetX)
     }
 }
 
-size_t bufferToRle(uchar *buffer, int size, int offsetX, int y, VRle::Span *out)
+static void bufferToRle(const uchar *buffer, int size, int offsetX, int y,
+                        std::vector<VRle::Span> &out)
 {
-    size_t count = 0;
-    uchar  value = buffer[0];
-    int    curIndex = 0;
+    uchar value = buffer[0];
+    int   curIndex = 0;
 
-    size = offsetX < 0 ? size + offsetX : size;
     for (int i = 0; i < size; i++) {
-        uchar curValue = buffer[0];
+        uchar curValue = buffer[i];
         if (value != curValue) {
-            if (value) {
-                out->y = y;
-                out->x = offsetX + curIndex;
-                out->len = i - curIndex;
-                out->coverage = value;
-                out++;
-                count++;
-            }
+            if (value) addRowSpan(out, offsetX + curIndex, y, i - curIndex, value);
             curIndex = i;
             value = curValue;
         }
-        buffer++;
-    }
-    if (value) {
-        out->y = y;
-        out->x = offsetX + curIndex;
-        out->len = size - curIndex;
-        out->coverage = value;
-        count++;
     }
-    return count;
+    if (value) addRowSpan(out, offsetX + curIndex, y, size - curIndex, value);
 }
 
-static void rleOpGeneric(VRleHelper *a, VRleHelper *b, VRleHelper *result,
-                         Operation op)
+/*
+ * the rows present in both rle are blended in a coverage buffer as wide as
+ * the row, the result is appended to the output.
+ */
+static void rleOpGeneric(VRleHelper *a, VRleHelper *b,
+                         std::vector<VRle::Span> &result, Operation op)
 {
-    std::array<VRle::Span, 256> temp;
-    VRle::Span *                out = result->spans;
-    size_t                      available = result->alloc;
-    VRle::Span *                aPtr = a->spans;
-    VRle::Span *                aEnd = a->spans + a->size;
-    VRle::Span *                bPtr = b->spans;
-    VRle::Span *                bEnd = b->spans + b->size;
-
-    while (available && aPtr < aEnd && bPtr < bEnd) {
+    std::vector<uchar> row;
+    VRle::Span *       aPtr = a->spans;
+    VRle::Span *       aEnd = a->spans + a->size;
+    VRle::Span *       bPtr = b->spans;
+    VRle::Span *       bEnd = b->spans + b->size;
+
+    while (aPtr < aEnd && bPtr < bEnd) {
         if (aPtr->y < bPtr->y) {
-            *out++ = *aPtr++;
-            available--;
+            result.push_back(*aPtr++);
         } else if (bPtr->y < aPtr->y) {
-            *out++ = *bPtr++;
-            available--;
+            result.push_back(*bPtr++);
         } else {  // same y
             VRle::Span *aStart = aPtr;
             VRle::Span *bStart = bPtr;
@@ -624,55 +595,38 @@ static void rleOpGeneric(VRleHelper *a, VRleHelper *b, VRleHelper *result,
             int aLength = (aPtr - 1)->x + (aPtr - 1)->len;
             int bLength = (bPtr - 1)->x + (bPtr - 1)->len;
             int offset = std::min(aStart->x, bStart->x);
+            int width = std::max(aLength, bLength) - offset;
 
-            std::array<uchar, 1024> array = {{0}};
-            blit(aStart, (aPtr - aStart), array.data(), -offset);
+            row.assign(size_t(width), 0);
+            blit(aStart, int(aPtr - aStart), row.data(), -offset);
             if (op == Operation::Add)
-                blitSrcOver(bStart, (bPtr - bStart), array.data(), -offset);
+                blitSrcOver(bStart, int(bPtr - bStart), row.data(), -offset);
             else if (op == Operation::Xor)
-                blitXor(bStart, (bPtr - bStart), array.data(), -offset);
-            VRle::Span *tResult = temp.data();
-            size_t size = bufferToRle(array.data(), std::max(aLength, bLength),
-                                      offset, y, tResult);
-            if (available >= size) {
-                while (size--) {
-                    *out++ = *tResult++;
-                    available--;
-                }
-            } else {
-                aPtr = aStart;
-                bPtr = bStart;
-                break;
-            }
+                blitXor(bStart, int(bPtr - bStart), row.data(), -offset);
+            bufferToRle(row.data(), width, offset, y, result);
         }
     }
     // update the span list that yet to be processed
     a->spans = aPtr;
-    a->size = aEnd - aPtr;
+    a->size = size_t(aEnd - aPtr);
 
     // update the clip list that yet to be processed
     b->spans = bPtr;
-    b->size = bEnd - bPtr;
-
-    // update the result
-    result->size = result->alloc - available;
+    b->size = size_t(bEnd - bPtr);
 }
 
 static void rleSubstractWithRle(VRleHelper *a, VRleHelper *b,
-                                VRleHelper *result)
+                                std::vector<VRle::Span> &result)
 {
-    std::array<VRle::Span, 256> temp;
-    VRle::Span *                out = result->spans;
-    size_t                      available = result->alloc;
-    VRle::Span *                aPtr = a->spans;
-    VRle::Span *                aEnd = a->spans + a->size;
-    VRle::Span *                bPtr = b->spans;
-    VRle::Span *                bEnd = b->spans + b->size;
-
-    while (available && aPtr < aEnd && bPtr < bEnd) {
+    std::vector<uchar> row;
+    VRle::Span *       aPtr = a->spans;
+    VRle::Span *       aEnd = a->spans + a->size;
+    VRle::Span *       bPtr = b->spans;
+    VRle::Span *       bEnd = b->spans + b->size;
+
+    while (aPtr < aEnd && bPtr < bEnd) {
         if (aPtr->y < bPtr->y) {
-            *out++ = *aPtr++;
-            available--;
+            result.push_back(*aPtr++);
         } else if (bPtr->y < aPtr->y) {
             bPtr++;
         } else {  // same y
@@ -687,23 +641,13 @@ static void rleSubstractWithRle(VRleHelper *a, VRleHelper *b,
             int aLength = (aPtr - 1)->x + (aPtr - 1)->len;
             int bLength = (bPtr - 1)->x + (bPtr - 1)->len;
             int offset = std::min(aStart->x, bStart->x);
+            int width = std::max(aLength, bLength) - offset;
 
-            std::array<uchar, 1024> array = {{0}};
-            blit(aStart, (aPtr - aStart), array.data(), -offset);
-            blitDestinationOut(bStart, (bPtr - bStart), array.data(), -offset);
-            VRle::Span *tResult = temp.data();
-            size_t size = bufferToRle(array.data(), std::max(aLength, bLength),
-                                      offset, y, tResult);
-            if (available >= size) {
-                while (size--) {
-                    *out++ = *tResult++;
-                    available--;
-                }
-            } else {
-                aPtr = aStart;
-                bPtr = bStart;
-                break;
-            }
+            row.assign(size_t(width), 0);
+            blit(aStart, int(aPtr - aStart), row.data(), -offset);
+            blitDestinationOut(bStart, int(bPtr - bStart), row.data(),
+                               -offset);
+            bufferToRle(row.data(), width, offset, y, result);
         }
     }
     // update the span list that yet to be processed
@@ -713,9 +657,6 @@ static void rleSubstractWithRle(VRleHelper *a, VRleHelper *b,
     // update the clip list that yet to be processed
     b->spans = bPtr;
     b->size = size_t(bEnd - bPtr);
-
-    // update the result
-    result->size = result->alloc - available;
 }
 
 VRle VRle::toRle(const VRect &rect)
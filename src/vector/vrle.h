@@ -30,8 +30,8 @@ V_BEGIN_NAMESPACE
 class VRle {
 public:
     struct Span {
-        short  x{0};
-        short  y{0};
+        int    x{0};
+        int    y{0};
         ushort len{0};
         uchar  coverage{0};
     };
@@ -61,6 +61,7 @@ public:
 
     bool unique() const {return d.unique();}
     size_t refCount() const { return d.refCount();}
+    size_t memorySize() const;
     void clone(const VRle &o);
 
 public:
@@ -85,7 +86,6 @@ public:
         void  addRect(const VRect &rect);
         void  clone(const VRle::VRleData &);
         std::vector<VRle::Span> mSpans;
-        VPoint                  mOffset;
         mutable VRect           mBbox;
         mutable bool            mBboxDirty = true;
     };
@@ -169,6 +169,11 @@ inline VRle VRle::operator-(const VRle &o) const
     return result;
 }
 
+inline size_t VRle::memorySize() const
+{
+    return d->mSpans.capacity() * sizeof(VRle::Span);
+}
+
 inline void VRle::reset()
 {
     d.write().reset();
@@ -2,6 +2,7 @@
 #define VSHAREDPTR_H
 
 #include <cassert>
+#include <atomic>
 #include <memory>
 
 template <typename T, typename Rc>
@@ -1,5 +1,10 @@
 #include <gtest/gtest.h>
 #include "rlottie.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
 
 class AnimationTest : public ::testing::Test {
 public:
@@ -32,3 +37,407 @@ TEST_F(AnimationTest, loadFromFile) {
     ASSERT_EQ(width, 500);
     ASSERT_EQ(height, 500);
 }
+
+TEST(AnimationImageTest, renderAfterImageEviction) {
+    std::string filePath = DEMO_DIR;
+    filePath +="image_embedded.json";
+    auto image = rlottie::Animation::loadFromFile(filePath, false);
+    ASSERT_TRUE(image != nullptr);
+
+    size_t width = 200, height = 200;
+    std::vector<uint32_t> first(width * height);
+    std::vector<uint32_t> second(width * height);
+    rlottie::Surface s1(first.data(), width, height, width * 4);
+    rlottie::Surface s2(second.data(), width, height, width * 4);
+
+    image->renderSync(0, s1);
+    // drop all decoded images, they should be decoded again on demand.
+    rlottie::configureImageCacheSize(0);
+    image->renderSync(image->totalFrame() / 2, s2);
+    image->renderSync(0, s2);
+    rlottie::configureImageCacheSize(64 * 1024 * 1024);
+
+    ASSERT_EQ(first, second);
+}
+
+TEST(AnimationImageTest, imageSharedBetweenModels) {
+    std::string filePath = DEMO_DIR;
+    filePath +="image_embedded.json";
+    auto first = rlottie::Animation::loadFromFile(filePath, false);
+    auto second = rlottie::Animation::loadFromFile(filePath, false);
+    ASSERT_TRUE(first != nullptr);
+    ASSERT_TRUE(second != nullptr);
+
+    size_t width = 200, height = 200;
+    std::vector<uint32_t> buffer(width * height);
+    rlottie::Surface surface(buffer.data(), width, height, width * 4);
+
+    first->renderSync(0, surface);
+    auto stats = rlottie::imageCacheStats();
+    // image loader module is not available.
+    if (!stats.count) return;
+    // the embedded data is held by the cache with the bitmap.
+    ASSERT_GT(stats.dataSize, 0u);
+    ASSERT_GT(stats.size, stats.dataSize);
+
+    second->renderSync(0, surface);
+    auto shared = rlottie::imageCacheStats();
+
+    ASSERT_GT(shared.hits, stats.hits);
+    ASSERT_EQ(shared.misses, stats.misses);
+    ASSERT_EQ(shared.count, stats.count);
+}
+
+TEST_F(AnimationTest, releaseResources) {
+    size_t width = 200, height = 200;
+    std::vector<uint32_t> first(width * height);
+    std::vector<uint32_t> second(width * height);
+    rlottie::Surface s1(first.data(), width, height, width * 4);
+    rlottie::Surface s2(second.data(), width, height, width * 4);
+
+    animation->renderSync(10, s1);
+    ASSERT_GT(animation->releaseResources(), 0u);
+    rlottie::trimMemory(rlottie::TrimLevel::Complete);
+    // resources are recreated on the next render.
+    animation->renderSync(10, s2);
+
+    ASSERT_EQ(first, second);
+
+    // the release waits for an async render instead of being skipped.
+    std::fill(second.begin(), second.end(), 0);
+    auto result = animation->render(10, s2);
+    ASSERT_GT(animation->releaseResources(), 0u);
+    result.get();
+
+    ASSERT_EQ(first, second);
+
+    // shapes that stay fully inside the surface reuse their rle when they
+    // don't move, which must not happen once it has been released.
+    std::string filePath = DEMO_DIR;
+    filePath += "done.json";
+    auto unclipped = rlottie::Animation::loadFromFile(filePath, false);
+    ASSERT_TRUE(unclipped != nullptr);
+    unclipped->renderSync(38, s1);
+    ASSERT_GT(unclipped->releaseResources(), 0u);
+    unclipped->renderSync(38, s2);
+
+    ASSERT_EQ(first, second);
+}
+
+TEST_F(AnimationTest, binaryModel) {
+    std::string binPath = "binary_model_test.bin";
+    ASSERT_TRUE(animation->saveToBinary(binPath));
+
+    auto binary = rlottie::Animation::loadFromBinary(binPath, false);
+    ASSERT_TRUE(binary != nullptr);
+    ASSERT_EQ(binary->totalFrame(), animation->totalFrame());
+    ASSERT_EQ(binary->frameRate(), animation->frameRate());
+
+    size_t width = 200, height = 200;
+    std::vector<uint32_t> first(width * height);
+    std::vector<uint32_t> second(width * height);
+    rlottie::Surface s1(first.data(), width, height, width * 4);
+    rlottie::Surface s2(second.data(), width, height, width * 4);
+
+    for (size_t i = 0; i < animation->totalFrame(); i += 5) {
+        animation->renderSync(i, s1);
+        binary->renderSync(i, s2);
+        ASSERT_EQ(first, second);
+    }
+
+    // json data is not a binary model.
+    std::string filePath = DEMO_DIR;
+    filePath +="mask.json";
+    ASSERT_FALSE(rlottie::Animation::loadFromBinary(filePath, false));
+
+    // a truncated or corrupt file is either rejected or loads into a model
+    // that can be rendered.
+    std::string corruptPath = "binary_model_corrupt.bin";
+    for (auto file : {"done.json", "bell.json", "gradient_sleepy_loader.json"}) {
+        filePath = DEMO_DIR;
+        filePath += file;
+        auto source = rlottie::Animation::loadFromFile(filePath, false);
+        ASSERT_TRUE(source != nullptr);
+        ASSERT_TRUE(source->saveToBinary(binPath));
+        std::ifstream in(binPath, std::ios::binary);
+        std::string bin((std::istreambuf_iterator<char>(in)),
+                        std::istreambuf_iterator<char>());
+        for (size_t i = 0; i < bin.size(); i++) {
+            for (bool truncate : {false, true}) {
+                std::string data = truncate ? bin.substr(0, i) : bin;
+                if (!truncate) data[i] = 0;
+                {
+                    std::ofstream out(corruptPath, std::ios::binary);
+                    out << data;
+                }
+                auto corrupt =
+                    rlottie::Animation::loadFromBinary(corruptPath, false);
+                if (corrupt) corrupt->renderSync(0, s1);
+            }
+        }
+        // a null object in front of the children of a group, everything
+        // else stays readable so only the null child itself can be caught.
+        for (size_t i = 0; i + 4 <= bin.size(); i++) {
+            uint32_t count;
+            std::memcpy(&count, bin.data() + i, 4);
+            if (count == 0 || count > 64) continue;
+            std::string data = bin;
+            count++;
+            std::memcpy(&data[i], &count, 4);
+            data.insert(i + 4, 1, '\0');
+            {
+                std::ofstream out(corruptPath, std::ios::binary);
+                out << data;
+            }
+            auto corrupt = rlottie::Animation::loadFromBinary(corruptPath, false);
+            if (corrupt) corrupt->renderSync(0, s1);
+        }
+    }
+    std::remove(corruptPath.c_str());
+
+    std::remove(binPath.c_str());
+}
+
+TEST_F(AnimationTest, loadFromReadOnlyData) {
+    std::string filePath = DEMO_DIR;
+    filePath +="mask.json";
+    std::ifstream f(filePath);
+    std::string content((std::istreambuf_iterator<char>(f)),
+                        std::istreambuf_iterator<char>());
+    const std::string copy = content;
+
+    auto data = rlottie::Animation::loadFromData(content.data(), content.size(),
+                                                 "read_only_mask", "", false);
+    ASSERT_TRUE(data != nullptr);
+    // the caller buffer must be left untouched.
+    ASSERT_EQ(content, copy);
+
+    size_t width = 200, height = 200;
+    std::vector<uint32_t> first(width * height);
+    std::vector<uint32_t> second(width * height);
+    rlottie::Surface s1(first.data(), width, height, width * 4);
+    rlottie::Surface s2(second.data(), width, height, width * 4);
+
+    animation->renderSync(10, s1);
+    data->renderSync(10, s2);
+    ASSERT_EQ(first, second);
+}
+
+TEST(AnimationKeyPathTest, valueOfConstantAnimation) {
+    // the fill color is animated but keeps one value.
+    std::string json = R"({"v":"5.5.2","fr":30,"ip":0,"op":20,"w":100,"h":100,
+        "layers":[{"ty":4,"nm":"layer","ind":1,"ip":0,"op":20,"st":0,
+        "ks":{"o":{"a":0,"k":100},"r":{"a":0,"k":0},"p":{"a":0,"k":[50,50,0]},
+              "a":{"a":0,"k":[0,0,0]},"s":{"a":0,"k":[100,100,100]}},
+        "shapes":[{"ty":"rc","nm":"rect","d":1,"s":{"a":0,"k":[100,100]},
+                   "p":{"a":0,"k":[0,0]},"r":{"a":0,"k":0}},
+                  {"ty":"fl","nm":"fill","o":{"a":0,"k":100},"r":1,
+                   "c":{"a":1,"k":[{"t":0,"s":[1,0,0,1],"e":[1,0,0,1],
+                                    "i":{"x":[0.5],"y":[0.5]},
+                                    "o":{"x":[0.5],"y":[0.5]}},
+                                   {"t":20,"s":[1,0,0,1]}]}}]}],
+        "assets":[]})";
+    auto animation =
+        rlottie::Animation::loadFromData(json, "constant_fill", "", false);
+    ASSERT_TRUE(animation != nullptr);
+
+    size_t width = 100, height = 100;
+    std::vector<uint32_t> buffer(width * height);
+    rlottie::Surface surface(buffer.data(), width, height, width * 4);
+    animation->renderSync(0, surface);
+    ASSERT_EQ(buffer[50 * width + 50], 0xffff0000u);
+
+    // a value set after the load follows the frames like the animation.
+    animation->setValue<rlottie::Property::FillColor>(
+        "**", [](const rlottie::FrameInfo &info) {
+            return info.curFrame() < 10 ? rlottie::Color(0, 1, 0)
+                                        : rlottie::Color(0, 0, 1);
+        });
+    animation->renderSync(5, surface);
+    ASSERT_EQ(buffer[50 * width + 50], 0xff00ff00u);
+    animation->renderSync(15, surface);
+    ASSERT_EQ(buffer[50 * width + 50], 0xff0000ffu);
+}
+
+TEST(AnimationKeyPathTest, valueOfLaterRepeaterCopy) {
+    // the third copy of the repeater only shows from frame 10 on.
+    std::string json = R"({"v":"5.5.2","fr":30,"ip":0,"op":20,"w":100,"h":100,
+        "layers":[{"ty":4,"nm":"layer","ind":1,"ip":0,"op":20,"st":0,
+        "ks":{"o":{"a":0,"k":100},"r":{"a":0,"k":0},"p":{"a":0,"k":[20,50,0]},
+              "a":{"a":0,"k":[0,0,0]},"s":{"a":0,"k":[100,100,100]}},
+        "shapes":[{"ty":"rc","nm":"rect","d":1,"s":{"a":0,"k":[20,20]},
+                   "p":{"a":0,"k":[0,0]},"r":{"a":0,"k":0}},
+                  {"ty":"fl","nm":"fill","o":{"a":0,"k":100},"r":1,
+                   "c":{"a":0,"k":[1,0,0,1]}},
+                  {"ty":"rp","nm":"repeater","m":1,"o":{"a":0,"k":0},
+                   "c":{"a":1,"k":[{"t":0,"s":[1],"h":1},{"t":10,"s":[3]}]},
+                   "tr":{"ty":"tr","p":{"a":0,"k":[30,0]},
+                         "a":{"a":0,"k":[0,0]},"s":{"a":0,"k":[100,100]},
+                         "r":{"a":0,"k":0},"so":{"a":0,"k":100},
+                         "eo":{"a":0,"k":100}}}]}],
+        "assets":[]})";
+    auto animation =
+        rlottie::Animation::loadFromData(json, "repeater_fill", "", false);
+    ASSERT_TRUE(animation != nullptr);
+
+    size_t width = 100, height = 100;
+    std::vector<uint32_t> buffer(width * height);
+    rlottie::Surface surface(buffer.data(), width, height, width * 4);
+    animation->renderSync(0, surface);
+    ASSERT_EQ(buffer[50 * width + 20], 0xffff0000u);
+    ASSERT_EQ(buffer[50 * width + 80], 0u);
+
+    // the value also reaches the copies created after it was set.
+    animation->setValue<rlottie::Property::FillColor>("**",
+                                                      rlottie::Color(0, 1, 0));
+    animation->renderSync(15, surface);
+    ASSERT_EQ(buffer[50 * width + 20], 0xff00ff00u);
+    ASSERT_EQ(buffer[50 * width + 50], 0xff00ff00u);
+    ASSERT_EQ(buffer[50 * width + 80], 0xff00ff00u);
+}
+
+TEST_F(AnimationTest, loadAsync) {
+    std::string filePath = DEMO_DIR;
+    filePath +="mask.json";
+
+    // concurrent loads of the same resource share one parse.
+    std::vector<std::future<std::unique_ptr<rlottie::Animation>>> loads;
+    for (int i = 0; i < 4; i++)
+        loads.push_back(rlottie::Animation::loadFromFileAsync(filePath));
+
+    for (auto &load : loads) {
+        auto result = load.get();
+        ASSERT_TRUE(result != nullptr);
+        ASSERT_EQ(result->totalFrame(), animation->totalFrame());
+    }
+
+    ASSERT_FALSE(rlottie::Animation::loadFromFileAsync("wrong_file.json").get());
+
+    std::ifstream f(filePath);
+    std::string content((std::istreambuf_iterator<char>(f)),
+                        std::istreambuf_iterator<char>());
+    auto data = rlottie::Animation::loadFromDataAsync(content, "async_mask").get();
+    ASSERT_TRUE(data != nullptr);
+    ASSERT_EQ(data->totalFrame(), animation->totalFrame());
+
+    // more loads of a key that is being parsed than there are pool threads,
+    // the ones waiting for the parse don't hold a thread.
+    filePath = DEMO_DIR;
+    filePath += "loading.json";
+    std::ifstream large(filePath);
+    content.assign(std::istreambuf_iterator<char>(large),
+                   std::istreambuf_iterator<char>());
+    // keeps the pool busy so that the synchronous load parses first.
+    auto blocker = rlottie::Animation::loadFromDataAsync(content, "async_busy");
+    std::vector<std::future<std::unique_ptr<rlottie::Animation>>> shared;
+    for (int i = 0; i < 16; i++)
+        shared.push_back(
+            rlottie::Animation::loadFromDataAsync(content, "async_shared"));
+    auto sync = rlottie::Animation::loadFromData(content, "async_shared");
+    ASSERT_TRUE(sync != nullptr);
+    for (auto &load : shared) {
+        auto result = load.get();
+        ASSERT_TRUE(result != nullptr);
+        ASSERT_EQ(result->totalFrame(), sync->totalFrame());
+    }
+    ASSERT_TRUE(blocker.get() != nullptr);
+}
+
+TEST_F(AnimationTest, skipUnknownValues) {
+    std::string filePath = DEMO_DIR;
+    filePath +="mask.json";
+    std::ifstream f(filePath);
+    std::string content((std::istreambuf_iterator<char>(f)),
+                        std::istreambuf_iterator<char>());
+
+    // brackets inside the strings of a skipped value must not end it.
+    auto pos = content.find("\"layers\":[{");
+    ASSERT_NE(pos, std::string::npos);
+    content.insert(pos + 11, "\"ef\":[{\"nm\":\"a]}\\\"[{\",\"v\":[1e2,-0,"
+                             "{\"x\":[]}]}],");
+
+    auto data = rlottie::Animation::loadFromData(content, "skip_mask", "",
+                                                 false);
+    ASSERT_TRUE(data != nullptr);
+
+    size_t width = 200, height = 200;
+    std::vector<uint32_t> first(width * height);
+    std::vector<uint32_t> second(width * height);
+    rlottie::Surface s1(first.data(), width, height, width * 4);
+    rlottie::Surface s2(second.data(), width, height, width * 4);
+
+    animation->renderSync(10, s1);
+    data->renderSync(10, s2);
+    ASSERT_EQ(first, second);
+}
+
+TEST(AnimationLargeTest, renderLargePathOnWideSurface) {
+    // a fill with more points than a short can index, on a surface wider
+    // than a short can address, restricted by two masks added together.
+    const size_t width = 40000, height = 8, vertexCount = 12000;
+    auto rect = [](size_t l, size_t r) {
+        return "{\"c\":true,\"v\":[[" + std::to_string(l) + ",0],[" +
+               std::to_string(r) + ",0],[" + std::to_string(r) + ",8],[" +
+               std::to_string(l) + ",8]],\"i\":[[0,0],[0,0],[0,0],[0,0]],"
+               "\"o\":[[0,0],[0,0],[0,0],[0,0]]}";
+    };
+    std::string v, t;
+    for (size_t i = 0; i <= vertexCount; i++) {
+        v += "[" + std::to_string(i * width / vertexCount) + ",0],";
+        t += "[0,0],";
+    }
+    v += "[" + std::to_string(width) + ",8],[0,8]";
+    t += "[0,0],[0,0]";
+    std::string json =
+        "{\"v\":\"5.5.2\",\"fr\":30,\"ip\":0,\"op\":1,\"w\":" +
+        std::to_string(width) + ",\"h\":" + std::to_string(height) +
+        ",\"layers\":[{\"ty\":4,\"ind\":1,\"ip\":0,\"op\":1,\"st\":0,"
+        "\"ks\":{},\"hasMask\":true,\"masksProperties\":["
+        "{\"mode\":\"a\",\"o\":{\"a\":0,\"k\":100},\"pt\":{\"a\":0,\"k\":" +
+        rect(0, 30000) +
+        "}},{\"mode\":\"a\",\"o\":{\"a\":0,\"k\":100},\"pt\":{\"a\":0,"
+        "\"k\":" +
+        rect(10000, width) +
+        "}}],\"shapes\":[{\"ty\":\"sh\",\"ks\":{\"a\":0,\"k\":{\"c\":true,"
+        "\"v\":[" + v + "],\"i\":[" + t + "],\"o\":[" + t +
+        "]}}},{\"ty\":\"fl\",\"c\":{\"a\":0,\"k\":[1,0,0,1]},"
+        "\"o\":{\"a\":0,\"k\":100}}]}]}";
+
+    auto animation =
+        rlottie::Animation::loadFromData(json, "large_path", "", false);
+    ASSERT_TRUE(animation != nullptr);
+
+    std::vector<uint32_t> buffer(width * height);
+    rlottie::Surface surface(buffer.data(), width, height, width * 4);
+    animation->renderSync(0, surface);
+    ASSERT_EQ(buffer[4 * width + 10], 0xffff0000);
+    ASSERT_EQ(buffer[4 * width + 20000], 0xffff0000);
+    ASSERT_EQ(buffer[4 * width + width - 10], 0xffff0000);
+}
+
+TEST(AnimationSequenceTest, sequentialMatchesFreshRender) {
+    // content that only moved between frames reuses the previous rle, the
+    // result has to be the same as rendering the frame from scratch.
+    const char *files[] = {"looping_landscape_+_plane_+_clouds.json",
+                           "personal_character.json", "loading.json",
+                           "done.json"};
+    size_t width = 200, height = 200;
+    std::vector<uint32_t> sequential(width * height);
+    std::vector<uint32_t> fresh(width * height);
+    rlottie::Surface s1(sequential.data(), width, height, width * 4);
+    rlottie::Surface s2(fresh.data(), width, height, width * 4);
+
+    for (auto file : files) {
+        std::string filePath = DEMO_DIR;
+        filePath += file;
+        auto animation = rlottie::Animation::loadFromFile(filePath);
+        ASSERT_TRUE(animation != nullptr);
+        for (size_t i = 0; i < animation->totalFrame(); i++) {
+            animation->renderSync(i, s1);
+            if (i % 4) continue;
+            auto single = rlottie::Animation::loadFromFile(filePath);
+            single->renderSync(i, s2);
+            ASSERT_EQ(sequential, fresh) << file << " frame " << i;
+        }
+    }
+}
@@ -0,0 +1,44 @@
+#include <gtest/gtest.h>
+#include "lottiemodel.h"
+#include <cmath>
+
+/*
+ * the arc length table of a path keyframe replaces the search of the curve
+ * parameter with VBezier::tAtLength(), the positions it gives have to stay
+ * within 0.05 of the searched ones.
+ */
+TEST(LOTKeyFrameValueTest, arcLengthsMatchLengthSearch) {
+    unsigned seed = 1;
+    auto random = [&seed](float scale) {
+        seed = seed * 1103515245u + 12345u;
+        return float((seed >> 16) & 0x7fff) / 0x7fff * scale;
+    };
+
+    float worst = 0;
+    for (int n = 0; n < 200; n++) {
+        // short paths with cusps as well as long ones.
+        float scale = n % 3 == 0 ? 50 : (n % 3 == 1 ? 500 : 2000);
+
+        LOTKeyFrameValue<VPointF> search;
+        search.mPathKeyFrame = true;
+        search.mStartValue = VPointF(random(scale), random(scale));
+        search.mEndValue = VPointF(random(scale), random(scale));
+        search.mOutTangent =
+            VPointF(random(scale) - scale / 2, random(scale) - scale / 2);
+        search.mInTangent =
+            VPointF(random(scale) - scale / 2, random(scale) - scale / 2);
+
+        LOTKeyFrameValue<VPointF> table = search;
+        table.cacheArcLengths();
+        ASSERT_FALSE(table.mArcLengths.empty());
+
+        for (int i = 0; i <= 100; i++) {
+            float   t = float(i) / 100;
+            VPointF expected = search.value(t);
+            VPointF actual = table.value(t);
+            worst = std::max(worst, std::hypot(expected.x() - actual.x(),
+                                               expected.y() - actual.y()));
+        }
+    }
+    ASSERT_LE(worst, 0.05f);
+}
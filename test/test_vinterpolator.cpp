@@ -0,0 +1,23 @@
+#include <gtest/gtest.h>
+#include "vinterpolator.h"
+
+TEST(VInterpolatorTest, bakedValue) {
+    const float curves[][4] = {{0.42f, 0, 0.58f, 1},
+                               {0.167f, 0.167f, 0.833f, 0.833f},
+                               {0.33f, 0, 0.67f, 1},
+                               {0.8f, -0.6f, 0.2f, 1.6f},
+                               {0, 0, 1, 1}};
+    for (const auto &c : curves) {
+        VInterpolator curve(c[0], c[1], c[2], c[3]);
+        for (int frames : {1, 7, 60, 1024}) {
+            VInterpolator baked = curve;
+            baked.bake(frames);
+            ASSERT_EQ(baked.bakedFrames(), frames);
+            // integer frames give back the exact value.
+            for (int i = 0; i < frames; i++) {
+                float t = float(i) / float(frames);
+                ASSERT_EQ(baked.bakedValue(i), curve.value(t));
+            }
+        }
+    }
+}
@@ -1,5 +1,7 @@
 #include <gtest/gtest.h>
 #include "vpath.h"
+#include "vpathmesure.h"
+#include <algorithm>
 
 class VPathTest : public ::testing::Test {
 public:
@@ -188,3 +190,50 @@ TEST_F(VPathTest, addPolystarZeroRoundness) {
     ASSERT_EQ(pathPolystarZero.elements().size() , pathPolystarZero.elements().capacity());
     ASSERT_EQ(pathPolystarZero.points().size() , pathPolystarZero.points().capacity());
 }
+
+TEST_F(VPathTest, lengths) {
+    const auto &lengths = pathRect.lengths();
+    ASSERT_EQ(lengths.size(), pathRect.elements().size());
+    ASSERT_FLOAT_EQ(lengths.back(), pathRect.length());
+    ASSERT_FLOAT_EQ(pathRect.length(), 400);
+    ASSERT_TRUE(std::is_sorted(lengths.begin(), lengths.end()));
+}
+
+TEST_F(VPathTest, trim) {
+    VPathMesure mesure;
+    mesure.setRange(0.3f, 0.7f);
+    VPath result = mesure.trim(pathRect);
+    ASSERT_EQ(result.segments(), 1);
+    ASSERT_NEAR(result.length(), 160, 0.01);
+
+    // wraps around the start of the path.
+    mesure.setRange(0.9f, 0.1f);
+    result = mesure.trim(pathOvalCircle);
+    ASSERT_EQ(result.segments(), 2);
+    ASSERT_NEAR(result.length(), 0.2f * pathOvalCircle.length(), 0.5);
+}
+
+TEST_F(VPathTest, transform) {
+    VMatrix m;
+    m.translate(10, 20).rotate(30).scale(2, 3);
+    VPath path = pathPolystar;
+    path.transform(m);
+    ASSERT_EQ(path.points().size(), pathPolystar.points().size());
+    for (size_t i = 0; i < path.points().size(); i++) {
+        VPointF expected = m.map(pathPolystar.points()[i]);
+        ASSERT_EQ(path.points()[i].x(), expected.x());
+        ASSERT_EQ(path.points()[i].y(), expected.y());
+    }
+}
+
+TEST_F(VPathTest, boundingRect) {
+    VRectF box = pathRect.boundingRect();
+    ASSERT_FLOAT_EQ(box.left(), -10);
+    ASSERT_FLOAT_EQ(box.top(), -20);
+    ASSERT_FLOAT_EQ(box.width(), 100);
+    ASSERT_FLOAT_EQ(box.height(), 100);
+    ASSERT_TRUE(pathEmpty.boundingRect().empty());
+
+    VRect rect = VRectF(0.5, -1.5, 10, 2).toAlignedRect();
+    ASSERT_EQ(rect, VRect(0, -2, 11, 3));
+}
@@ -0,0 +1,246 @@
+#include <gtest/gtest.h>
+#include "v_ft_raster.h"
+#include "v_ft_stroker.h"
+#include "vpolylinestroker.h"
+#include <algorithm>
+#include <cstdlib>
+#include <vector>
+
+/*
+ * the outlines of the polyline stroker are compared with the ones of the
+ * freetype stroker it replaces by their coverage, the two only differ
+ * by the rounding to the 26.6 grid of the freetype stroker.
+ */
+class VPolylineStrokerTest : public ::testing::Test {
+public:
+    static constexpr int size = 128;
+
+    struct Outline {
+        std::vector<SW_FT_Vector> points;
+        std::vector<char>         tags;
+        std::vector<int>          contours;
+        std::vector<char>         contoursFlag;
+
+        void addPoint(const VPointF &pt)
+        {
+            points.push_back({SW_FT_Pos(pt.x() * 64), SW_FT_Pos(pt.y() * 64)});
+            tags.push_back(SW_FT_CURVE_TAG_ON);
+        }
+        void endContour(bool open)
+        {
+            contours.push_back(int(points.size()) - 1);
+            contoursFlag.push_back(open);
+        }
+        SW_FT_Outline ft()
+        {
+            SW_FT_Outline outline;
+            outline.n_points = int(points.size());
+            outline.n_contours = int(contours.size());
+            outline.points = points.data();
+            outline.tags = tags.data();
+            outline.contours = contours.data();
+            outline.contours_flag = contoursFlag.data();
+            outline.flags = 0;
+            return outline;
+        }
+    };
+
+    static void spans(int count, const SW_FT_Span *spans, void *user)
+    {
+        auto coverage = static_cast<std::vector<int> *>(user);
+        for (int i = 0; i < count; i++) {
+            for (int x = spans[i].x; x < spans[i].x + spans[i].len; x++)
+                (*coverage)[spans[i].y * size + x] += spans[i].coverage;
+        }
+    }
+    static void bbox(int, int, int, int, void *) {}
+
+    static std::vector<int> render(SW_FT_Outline outline)
+    {
+        std::vector<int>    coverage(size * size);
+        SW_FT_Raster_Params params;
+        params.source = &outline;
+        params.flags = SW_FT_RASTER_FLAG_DIRECT | SW_FT_RASTER_FLAG_AA |
+                       SW_FT_RASTER_FLAG_CLIP;
+        params.gray_spans = &spans;
+        params.bbox_cb = &bbox;
+        params.user = &coverage;
+        params.clip_box = {0, 0, size, size};
+        sw_ft_grays_raster.raster_render(nullptr, &params);
+        return coverage;
+    }
+
+    // only moveTo, lineTo and close, like the paths below.
+    static std::vector<int> freetype(const VPath &path, JoinStyle join,
+                                     float width, float miterLimit)
+    {
+        // a closed contour repeats its first point like FTOutline::close().
+        Outline input;
+        size_t  index = 0, start = 0;
+        bool    open = false;
+        for (auto element : path.elements()) {
+            if (element == VPath::Element::Close) {
+                input.addPoint(path.points()[start]);
+                open = false;
+                continue;
+            }
+            if (element == VPath::Element::MoveTo) {
+                if (!input.points.empty()) input.endContour(open);
+                open = true;
+                start = index;
+            }
+            input.addPoint(path.points()[index++]);
+        }
+        input.endContour(open);
+
+        SW_FT_Stroker stroker;
+        SW_FT_Stroker_New(&stroker);
+        SW_FT_Stroker_Set(stroker, SW_FT_Fixed(width / 2 * 64),
+                          SW_FT_STROKER_LINECAP_BUTT,
+                          join == JoinStyle::Bevel
+                              ? SW_FT_STROKER_LINEJOIN_BEVEL
+                              : SW_FT_STROKER_LINEJOIN_MITER_FIXED,
+                          SW_FT_Fixed(miterLimit * (1 << 16)));
+        auto source = input.ft();
+        SW_FT_Stroker_ParseOutline(stroker, &source);
+        unsigned points, contours;
+        SW_FT_Stroker_GetCounts(stroker, &points, &contours);
+
+        Outline result;
+        result.points.resize(points);
+        result.tags.resize(points);
+        result.contours.resize(contours);
+        result.contoursFlag.resize(contours);
+        auto outline = result.ft();
+        outline.n_points = outline.n_contours = 0;
+        SW_FT_Stroker_Export(stroker, &outline);
+        SW_FT_Stroker_Done(stroker);
+        return render(outline);
+    }
+
+    static std::vector<int> polyline(const VPath &path, JoinStyle join,
+                                     float width, float miterLimit)
+    {
+        VPolylineStroker stroker;
+        EXPECT_TRUE(stroker.stroke(path, VMatrix(), CapStyle::Flat, join,
+                                   width, miterLimit));
+        Outline result;
+        size_t  start = 0;
+        for (auto end : stroker.contours()) {
+            for (size_t i = start; i < end; i++)
+                result.addPoint(stroker.points()[i]);
+            result.endContour(false);
+            start = end;
+        }
+        return render(result.ft());
+    }
+
+    /*
+     * pixels on the edges may differ a little by the rounding, a wrong
+     * join or cap differs by full pixels.
+     */
+    static void compare(const VPath &path, JoinStyle join, float width,
+                        float miterLimit = 4)
+    {
+        auto expected = freetype(path, join, width, miterLimit);
+        auto actual = polyline(path, join, width, miterLimit);
+        int  maxDiff = 0;
+        long area = 0, areaDiff = 0;
+        for (size_t i = 0; i < expected.size(); i++) {
+            maxDiff = std::max(maxDiff, std::abs(expected[i] - actual[i]));
+            area += expected[i];
+            areaDiff += expected[i] - actual[i];
+        }
+        EXPECT_LE(maxDiff, 16);
+        EXPECT_LE(std::labs(areaDiff), area / 256);
+    }
+};
+
+TEST_F(VPolylineStrokerTest, openPath) {
+    VPath path;
+    path.moveTo(10, 10);
+    path.lineTo(100, 20);
+    path.lineTo(40, 60);
+    path.lineTo(110, 110);
+    compare(path, JoinStyle::Miter, 6);
+    compare(path, JoinStyle::Bevel, 6);
+}
+
+TEST_F(VPolylineStrokerTest, closedPath) {
+    VPath path;
+    path.moveTo(20, 20);
+    path.lineTo(100, 30);
+    path.lineTo(60, 100);
+    path.close();
+    path.moveTo(10, 110);
+    path.lineTo(40, 80);
+    path.lineTo(70, 115);
+    path.lineTo(10, 110);
+    path.close();
+    compare(path, JoinStyle::Miter, 8);
+    compare(path, JoinStyle::Bevel, 8);
+}
+
+TEST_F(VPolylineStrokerTest, zeroLengthSegments) {
+    VPath path;
+    path.moveTo(10, 10);
+    path.lineTo(10, 10);
+    path.lineTo(90, 30);
+    path.lineTo(90, 30);
+    path.lineTo(50, 100);
+    compare(path, JoinStyle::Miter, 6);
+
+    // a subpath that has no length at all leaves no outline.
+    VPath dot;
+    dot.moveTo(50, 50);
+    dot.lineTo(50, 50);
+    VPolylineStroker stroker;
+    ASSERT_TRUE(stroker.stroke(dot, VMatrix(), CapStyle::Flat,
+                               JoinStyle::Miter, 6, 4));
+    ASSERT_TRUE(stroker.points().empty());
+    ASSERT_TRUE(stroker.contours().empty());
+}
+
+TEST_F(VPolylineStrokerTest, collinearPoints) {
+    VPath path;
+    path.moveTo(10, 20);
+    path.lineTo(60, 20);
+    path.lineTo(110, 20);
+    compare(path, JoinStyle::Miter, 6);
+
+    // turning back on the same line.
+    VPath back;
+    back.moveTo(10, 60);
+    back.lineTo(110, 60);
+    back.lineTo(50, 60);
+    compare(back, JoinStyle::Miter, 6);
+    compare(back, JoinStyle::Bevel, 6);
+}
+
+TEST_F(VPolylineStrokerTest, miterLimit) {
+    // the miter of the sharp corner is longer than the limit and falls
+    // back to a bevel, the blunt one keeps its miter.
+    VPath path;
+    path.moveTo(10, 10);
+    path.lineTo(110, 30);
+    path.lineTo(10, 50);
+    path.lineTo(40, 110);
+    compare(path, JoinStyle::Miter, 8, 2);
+    compare(path, JoinStyle::Miter, 8, 10);
+}
+
+TEST_F(VPolylineStrokerTest, unsupportedPath) {
+    VPath path;
+    path.moveTo(10, 10);
+    path.cubicTo(40, 10, 60, 50, 100, 50);
+    VPolylineStroker stroker;
+    ASSERT_FALSE(stroker.stroke(path, VMatrix(), CapStyle::Flat,
+                                JoinStyle::Miter, 6, 4));
+    path.reset();
+    path.moveTo(10, 10);
+    path.lineTo(100, 50);
+    ASSERT_FALSE(stroker.stroke(path, VMatrix(), CapStyle::Round,
+                                JoinStyle::Miter, 6, 4));
+    ASSERT_FALSE(stroker.stroke(path, VMatrix(), CapStyle::Flat,
+                                JoinStyle::Round, 6, 4));
+}
@@ -0,0 +1,134 @@
+#include <gtest/gtest.h>
+#include "v_ft_raster.h"
+#include "vrectrle.h"
+#include <cstdlib>
+#include <vector>
+
+/*
+ * the rle of an axis aligned rect is generated without the raster, its
+ * spans have to be the same as the ones the raster gives for the path.
+ */
+class VRectRleTest : public ::testing::Test {
+public:
+    static void spans(int count, const SW_FT_Span *spans, void *user)
+    {
+        static_cast<VRle *>(user)->addSpan(
+            reinterpret_cast<const VRle::Span *>(spans), size_t(count));
+    }
+    static void bbox(int x, int y, int w, int h, void *user)
+    {
+        static_cast<VRle *>(user)->setBoundingRect({x, y, w, h});
+    }
+
+    // converts the path like FTOutline and renders it like VRasterizer.
+    static VRle raster(const VPath &path, const VMatrix &m, const VRect &clip)
+    {
+        std::vector<SW_FT_Vector> points;
+        for (const auto &pt : path.points()) {
+            VPointF p = m.map(pt);
+            points.push_back({SW_FT_Pos(p.x() * 64), SW_FT_Pos(p.y() * 64)});
+        }
+        if (path.elements().back() == VPath::Element::Close)
+            points.push_back(points.front());
+        std::vector<char> tags(points.size(), SW_FT_CURVE_TAG_ON);
+        int               contour = int(points.size()) - 1;
+        char              contourFlag = 0;
+
+        SW_FT_Outline outline;
+        outline.n_points = int(points.size());
+        outline.n_contours = 1;
+        outline.points = points.data();
+        outline.tags = tags.data();
+        outline.contours = &contour;
+        outline.contours_flag = &contourFlag;
+        outline.flags = 0;
+
+        VRle                rle;
+        SW_FT_Raster_Params params;
+        params.source = &outline;
+        params.flags = SW_FT_RASTER_FLAG_DIRECT | SW_FT_RASTER_FLAG_AA;
+        params.gray_spans = &spans;
+        params.bbox_cb = &bbox;
+        params.user = &rle;
+        if (!clip.empty()) {
+            params.flags |= SW_FT_RASTER_FLAG_CLIP;
+            params.clip_box.xMin = clip.left();
+            params.clip_box.yMin = clip.top();
+            params.clip_box.xMax = clip.right();
+            params.clip_box.yMax = clip.bottom();
+        }
+        sw_ft_grays_raster.raster_render(nullptr, &params);
+        return rle;
+    }
+
+    static void collect(size_t count, const VRle::Span *spans, void *user)
+    {
+        auto list = static_cast<std::vector<VRle::Span> *>(user);
+        list->insert(list->end(), spans, spans + count);
+    }
+    static std::vector<VRle::Span> spanList(const VRle &rle)
+    {
+        std::vector<VRle::Span> list;
+        if (!rle.empty()) rle.intersect(rle.boundingRect(), &collect, &list);
+        return list;
+    }
+
+    static float random(float min, float max)
+    {
+        return min + (max - min) * float(std::rand()) / float(RAND_MAX);
+    }
+};
+
+TEST_F(VRectRleTest, randomRects) {
+    std::srand(1);
+    for (int i = 0; i < 20000; i++) {
+        VPath path;
+        path.addRect(VRectF(random(-20, 160), random(-20, 160),
+                            random(0, 100), random(0, 100)),
+                     i % 2 ? VPath::Direction::CW : VPath::Direction::CCW);
+
+        // a negative scale turns the winding around as well.
+        VMatrix m;
+        m.translate(random(-40, 40), random(-40, 40));
+        if (i % 3)
+            m.scale(random(0.25f, 3) * (i % 5 ? 1 : -1),
+                    random(0.25f, 3) * (i % 7 ? 1 : -1));
+
+        VRect clip;
+        if (i % 4)
+            clip = VRect(int(random(-10, 100)), int(random(-10, 100)),
+                         int(random(1, 120)), int(random(1, 120)));
+
+        VRle rle;
+        ASSERT_TRUE(rectRle(path, m, clip, rle));
+        VRle expected = raster(path, m, clip);
+
+        ASSERT_EQ(rle.empty(), expected.empty()) << "rect " << i;
+        if (rle.empty()) continue;
+        ASSERT_EQ(rle.boundingRect(), expected.boundingRect()) << "rect " << i;
+
+        auto actual = spanList(rle);
+        auto spans = spanList(expected);
+        ASSERT_EQ(actual.size(), spans.size()) << "rect " << i;
+        for (size_t j = 0; j < spans.size(); j++) {
+            ASSERT_EQ(actual[j].x, spans[j].x) << "rect " << i;
+            ASSERT_EQ(actual[j].y, spans[j].y) << "rect " << i;
+            ASSERT_EQ(actual[j].len, spans[j].len) << "rect " << i;
+            ASSERT_EQ(actual[j].coverage, spans[j].coverage) << "rect " << i;
+        }
+    }
+}
+
+TEST_F(VRectRleTest, otherPaths) {
+    VMatrix m;
+    VRle    rle;
+
+    VPath ellipse;
+    ellipse.addOval(VRectF(10, 10, 50, 30));
+    ASSERT_FALSE(rectRle(ellipse, m, VRect(), rle));
+
+    VPath rect;
+    rect.addRect(VRectF(10, 10, 50, 30));
+    m.rotate(30);
+    ASSERT_FALSE(rectRle(rect, m, VRect(), rle));
+}